@@ -1,5 +1,7 @@
 #include "audio_platform.h"
 #include "synth_engine.h"
+#include "synthesis/denormals.h"
+#include "rt_safety.h"
 #include <oboe/Oboe.h>
 #include <android/log.h>
 #include <memory>
@@ -137,6 +139,9 @@ public:
         void* audioData,
         int32_t numFrames) override {
         
+        ScopedDenormalsDisabled noDenormals;
+        SYNTH_RT_AUDIO_THREAD("onAudioReady");
+        
         if (!synth_engine_ || !is_running_.load()) {
             // Output silence
             std::memset(audioData, 0, numFrames * CHANNEL_COUNT * sizeof(float));
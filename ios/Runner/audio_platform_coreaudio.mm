@@ -1,5 +1,7 @@
 #include "audio_platform.h"
 #include "synth_engine.h"
+#include "synthesis/denormals.h"
+#include "rt_safety.h"
 #import <Foundation/Foundation.h>
 #import <AVFoundation/AVFoundation.h>
 #import <AudioUnit/AudioUnit.h>
@@ -265,6 +267,9 @@ private:
                         UInt32 inNumberFrames,
                         AudioBufferList* ioData) {
         
+        ScopedDenormalsDisabled noDenormals;
+        SYNTH_RT_AUDIO_THREAD("renderAudio");
+        
         if (!synth_engine_ || !is_running_.load()) {
             // Output silence
             for (UInt32 i = 0; i < ioData->mNumberBuffers; i++) {
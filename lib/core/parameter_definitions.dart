@@ -1,18 +1,15 @@
 /// Shared parameter definitions for all platforms
-/// These IDs must match the C++ implementation for native platforms
+/// These IDs must match SynthParameterId in native/src/synth_engine.h;
+/// the native engine rejects IDs it does not handle
 
 /// Parameter IDs used by the synth engine
 class SynthParameterId {
   // Master parameters
   static const int masterVolume = 0;
   static const int masterMute = 1;
-  
-  // Oscillator parameters
-  static const int oscillatorType = 2;
-  static const int oscillatorVolume = 3;
-  static const int oscillatorPanning = 4;
-  static const int oscillatorFineTune = 5;
-  static const int oscillatorPulseWidth = 6;
+  static const int polyphony = 7; // Voice limit, 1 - 64
+  static const int voiceStealPolicy = 8; // See VoiceStealPolicy
+  static const int parameterSmoothing = 9; // Ramp time in ms for continuous parameters
   
   // Filter parameters
   static const int filterCutoff = 10;
@@ -43,16 +40,39 @@ class SynthParameterId {
   static const int granularPan = 49;
   static const int granularPanVariation = 50;
   static const int granularWindowType = 51;
-  static const int granularPositionVar = 52; // Alias
-  static const int granularPitchVar = 53; // Alias
-  static const int granularDurationVar = 54; // Alias
-  static const int granularPanVar = 55; // Alias
+  static const int granularPositionVar = granularPositionVariation; // Alias
+  static const int granularPitchVar = granularPitchVariation; // Alias
+  static const int granularDurationVar = granularDurationVariation; // Alias
+  static const int granularPanVar = granularPanVariation; // Alias
+  
+  // Oscillators mixed into each voice (1 - 4)
+  static const int oscillatorCount = 90;
+  
+  // Oscillator parameters (per oscillator)
+  // For oscillator n, use: oscillatorType + (n * 10)
+  static const int oscillatorType = 100;
+  static const int oscillatorFrequency = 101;
+  static const int oscillatorDetune = 102;
+  static const int oscillatorVolume = 103;
+  static const int oscillatorPan = 104;
+  static const int oscillatorWavetableIndex = 105;
+  static const int oscillatorWavetablePosition = 106;
+  
+  // Modulation parameters
+  // For LFO n (0 - 3), use: lfoRate + (n * 2)
+  static const int lfoRate = 200; // Hz
+  static const int lfoShape = 201; // See LfoShape
   
-  // Wavetable parameters
-  static const int wavetablePosition = 60;
+  // For auxiliary envelope n (0 - 1), use: auxEnvelopeAttack + (n * 4)
+  static const int auxEnvelopeAttack = 210;
+  static const int auxEnvelopeDecay = 211;
+  static const int auxEnvelopeSustain = 212;
+  static const int auxEnvelopeRelease = 213;
   
-  // Microphone parameters
-  static const int microphoneVolume = 70;
+  // For modulation route n (0 - 7), use: modRouteSource + (n * 3)
+  static const int modRouteSource = 220; // 0 none, 1-4 LFO, 5-6 envelope
+  static const int modRouteDestination = 221; // Parameter ID below lfoRate, -1 none
+  static const int modRouteAmount = 222; // Offset in destination units
 }
 
 /// Oscillator types
@@ -81,6 +101,29 @@ enum FilterType {
   const FilterType(this.value);
 }
 
+/// LFO shapes (SynthParameterId.lfoShape)
+enum LfoShape {
+  sine(0),
+  triangle(1),
+  sawtooth(2),
+  square(3),
+  sampleAndHold(4);
+  
+  final int value;
+  const LfoShape(this.value);
+}
+
+/// What happens to a new note when every voice is busy
+enum VoiceStealPolicy {
+  sameNote(0), // Retrigger the voice already playing the note, else steal the oldest
+  oldest(1),
+  quietest(2),
+  none(3); // Drop the new note
+  
+  final int value;
+  const VoiceStealPolicy(this.value);
+}
+
 /// Grain window types
 enum GrainWindowType {
   rectangular(0),
@@ -0,0 +1,672 @@
+#include "include/synth_engine_api.h"
+#include "synthesis/delay.h"
+#include "synthesis/envelope.h"
+#include "synthesis/filter.h"
+#include "synthesis/multi_voice_oscillator.h"
+#include "synthesis/oscillator.h"
+#include "synthesis/reverb.h"
+#include "synthesis/voice_pool.h"
+#include "wavetable/wavetable_oscillator_impl.h"
+#include "granular/granular_synth.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Microbenchmarks for every DSP module and for the full render.
+//
+// Each case runs its block function repeatedly for at least --min-time
+// seconds after a short warm-up and reports the mean cost per sample.
+// Module cases run one mono stream (the granular case one stereo stream);
+// the engine cases count one stereo frame as a sample. Results go to
+// stdout as CSV, or as one JSON object per line with --format json, so
+// runs from different releases can be diffed or loaded into a sheet.
+//
+// With --mode scaling it instead finds, for each oscillator count and
+// grain density, the most voices the offline engine renders while the
+// mean time per block stays within --budget of the buffer period.
+
+namespace {
+
+struct Options {
+    std::string mode = "modules";
+    int sampleRate = 48000;
+    int blockSize = 256;
+    double minTime = 0.25;
+    std::string format; // Defaults to csv for modules, table for scaling
+    std::string filter;
+    double budget = 0.5;
+    int threads = 1;
+};
+
+struct Result {
+    std::string benchmark;
+    std::string variant;
+    int blockSize = 0;
+    long long samples = 0;
+    double nsPerSample = 0.0;
+};
+
+void printUsage() {
+    std::cerr << "Usage: synth_bench [options]\n"
+              << "  --mode MODE          modules or scaling (default: modules)\n"
+              << "  --sample-rate HZ     Sample rate (default: 48000)\n"
+              << "  --block FRAMES       Block size for the module cases and the buffer\n"
+              << "                       size for scaling (default: 256)\n"
+              << "  --min-time SECONDS   Minimum timed run per case (default: 0.25)\n"
+              << "  --format FORMAT      csv or json, or table for scaling\n"
+              << "                       (default: csv, table for scaling)\n"
+              << "  --filter TEXT        Only run cases whose benchmark name contains TEXT\n"
+              << "  --budget FRACTION    Scaling: share of the buffer period a block may\n"
+              << "                       take (default: 0.5)\n"
+              << "  --threads N          Scaling: render threads, 0 for one per core\n"
+              << "                       (default: 1)\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--mode") {
+            options.mode = value;
+        } else if (arg == "--sample-rate") {
+            options.sampleRate = std::atoi(value);
+        } else if (arg == "--block") {
+            options.blockSize = std::atoi(value);
+        } else if (arg == "--min-time") {
+            options.minTime = std::atof(value);
+        } else if (arg == "--format") {
+            options.format = value;
+        } else if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--budget") {
+            options.budget = std::atof(value);
+        } else if (arg == "--threads") {
+            options.threads = std::atoi(value);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.format.empty()) {
+        options.format = options.mode == "scaling" ? "table" : "csv";
+    }
+    if (options.mode != "modules" && options.mode != "scaling") {
+        return false;
+    }
+    const bool tableAllowed = options.mode == "scaling";
+    return options.sampleRate > 0 && options.blockSize > 0 && options.minTime > 0.0 &&
+           options.budget > 0.0 && options.threads >= 0 &&
+           (options.format == "csv" || options.format == "json" ||
+            (tableAllowed && options.format == "table"));
+}
+
+class Runner {
+public:
+    explicit Runner(const Options& options) : options(options) {
+        if (options.format == "csv") {
+            std::printf("benchmark,variant,block_size,samples,ns_per_sample,samples_per_sec\n");
+        }
+    }
+
+    /**
+     * Time one case and print its result.
+     *
+     * @param benchmark The module or stage name
+     * @param variant The configuration within it
+     * @param blockSize Samples produced by each call of block
+     * @param block Renders one block
+     */
+    void run(const std::string& benchmark, const std::string& variant, int blockSize,
+             const std::function<void()>& block) {
+        if (!options.filter.empty() && benchmark.find(options.filter) == std::string::npos) {
+            return;
+        }
+
+        using Clock = std::chrono::steady_clock;
+
+        // Warm caches and let start-up transients settle
+        const int warmupBlocks = std::max(1, options.sampleRate / 10 / blockSize);
+        for (int i = 0; i < warmupBlocks; ++i) {
+            block();
+        }
+
+        // Time batches of blocks so the clock reads stay out of the result
+        const int batch = std::max(1, 4096 / blockSize);
+        long long blocks = 0;
+        double elapsedNs = 0.0;
+        const double minNs = options.minTime * 1.0e9;
+        while (elapsedNs < minNs) {
+            const auto start = Clock::now();
+            for (int i = 0; i < batch; ++i) {
+                block();
+            }
+            elapsedNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            blocks += batch;
+        }
+
+        Result result;
+        result.benchmark = benchmark;
+        result.variant = variant;
+        result.blockSize = blockSize;
+        result.samples = blocks * blockSize;
+        result.nsPerSample = elapsedNs / static_cast<double>(result.samples);
+        print(result);
+    }
+
+private:
+    void print(const Result& result) const {
+        const double samplesPerSec = result.nsPerSample > 0.0 ? 1.0e9 / result.nsPerSample : 0.0;
+        if (options.format == "json") {
+            std::printf("{\"benchmark\":\"%s\",\"variant\":\"%s\",\"block_size\":%d,"
+                        "\"samples\":%lld,\"ns_per_sample\":%.4f,\"samples_per_sec\":%.0f}\n",
+                        result.benchmark.c_str(), result.variant.c_str(), result.blockSize,
+                        result.samples, result.nsPerSample, samplesPerSec);
+        } else {
+            std::printf("%s,%s,%d,%lld,%.4f,%.0f\n",
+                        result.benchmark.c_str(), result.variant.c_str(), result.blockSize,
+                        result.samples, result.nsPerSample, samplesPerSec);
+        }
+        std::fflush(stdout);
+    }
+
+    const Options& options;
+};
+
+// Fixed-seed white noise, the input for the processors
+std::vector<float> makeNoise(size_t length) {
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> noise(length);
+    for (float& sample : noise) {
+        sample = dist(random);
+    }
+    return noise;
+}
+
+// Processors run in place, so each block starts from a fresh copy of the
+// input; the copy is part of the measured cost but small next to the DSP
+void copyInput(const std::vector<float>& input, std::vector<float>& work) {
+    std::copy(input.begin(), input.begin() + work.size(), work.begin());
+}
+
+void benchOscillators(Runner& runner, const Options& options) {
+    static const struct {
+        Oscillator::WaveformType type;
+        const char* name;
+    } waveforms[] = {
+        {Oscillator::WaveformType::Sine, "sine"},
+        {Oscillator::WaveformType::Square, "square"},
+        {Oscillator::WaveformType::Triangle, "triangle"},
+        {Oscillator::WaveformType::Sawtooth, "sawtooth"},
+        {Oscillator::WaveformType::Noise, "noise"},
+        {Oscillator::WaveformType::Pulse, "pulse"}
+    };
+
+    std::vector<float> out(options.blockSize);
+    for (const auto& waveform : waveforms) {
+        Oscillator osc;
+        osc.setSampleRate(options.sampleRate);
+        osc.setFrequency(220.0f);
+        osc.setType(static_cast<int>(waveform.type));
+        runner.run("oscillator", waveform.name, options.blockSize, [&]() {
+            osc.processBlock(out.data(), options.blockSize);
+        });
+    }
+
+    // The SIMD kernel renders kLanes voices at once; report per voice sample
+    constexpr int lanes = MultiVoiceOscillator::kLanes;
+    std::vector<float> laneOut(static_cast<size_t>(options.blockSize) * lanes);
+    for (const auto& waveform : waveforms) {
+        if (!MultiVoiceOscillator::supports(waveform.type)) {
+            continue;
+        }
+        Oscillator osc;
+        osc.setSampleRate(options.sampleRate);
+        osc.setType(static_cast<int>(waveform.type));
+        float phases[lanes] = {};
+        float increments[lanes];
+        for (int lane = 0; lane < lanes; ++lane) {
+            increments[lane] = (110.0f * (lane + 1)) / options.sampleRate;
+        }
+        runner.run("multi_voice_oscillator", waveform.name, options.blockSize * lanes, [&]() {
+            std::fill(laneOut.begin(), laneOut.end(), 0.0f);
+            MultiVoiceOscillator::renderLanes(osc, laneOut.data(), options.blockSize, phases, increments);
+        });
+    }
+}
+
+// The frame storage Wavetable used before it packed every frame into one
+// aligned buffer: a heap vector per frame and a modulo per read. Kept as
+// the baseline for the morph benchmark.
+class NestedFrameTable {
+public:
+    explicit NestedFrameTable(const synth::Wavetable& table) {
+        for (size_t f = 0; f < table.getFrameCount(); ++f) {
+            const float* data = table.getFrameData(f, 0);
+            frames.emplace_back(data, data + table.getFrameSize());
+        }
+    }
+
+    float getSample(float phase, float position) const {
+        float frameIndex = position * (frames.size() - 1);
+        size_t frame0 = static_cast<size_t>(frameIndex);
+        size_t frame1 = (frame0 + 1) % frames.size();
+        float frameFraction = frameIndex - frame0;
+        return read(frames[frame0], phase) * (1.0f - frameFraction) +
+               read(frames[frame1], phase) * frameFraction;
+    }
+
+private:
+    static float read(const std::vector<float>& samples, float phase) {
+        float indexFloat = phase * samples.size();
+        size_t index = static_cast<size_t>(indexFloat);
+        float fraction = indexFloat - index;
+        size_t index0 = index % samples.size();
+        size_t index1 = (index0 + 1) % samples.size();
+        return samples[index0] * (1.0f - fraction) + samples[index1] * fraction;
+    }
+
+    std::vector<std::vector<float>> frames;
+};
+
+// Sweeps the table position across every frame once a second, moving it
+// on every sample, so each read lands on a new pair of frames
+void benchWavetableMorph(Runner& runner, const Options& options, const synth::Wavetable& table) {
+    const NestedFrameTable nested(table);
+    const float phaseIncrement = 220.0f / options.sampleRate;
+    const float positionIncrement = 1.0f / options.sampleRate;
+    std::vector<float> out(options.blockSize);
+
+    float phase = 0.0f;
+    float position = 0.0f;
+    auto advance = [&]() {
+        phase += phaseIncrement;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+        }
+        position += positionIncrement;
+        if (position >= 1.0f) {
+            position -= 1.0f;
+        }
+    };
+
+    runner.run("wavetable_morph", "nested_vectors", options.blockSize, [&]() {
+        for (int i = 0; i < options.blockSize; ++i) {
+            out[i] = nested.getSample(phase, position);
+            advance();
+        }
+    });
+
+    phase = position = 0.0f;
+    runner.run("wavetable_morph", "contiguous", options.blockSize, [&]() {
+        for (int i = 0; i < options.blockSize; ++i) {
+            out[i] = table.getSample(phase, position, 0);
+            advance();
+        }
+    });
+
+    // The engine's case: position fixed within a block, frames resolved once
+    phase = position = 0.0f;
+    runner.run("wavetable_morph", "contiguous_per_block", options.blockSize, [&]() {
+        const synth::Wavetable::Reader reader = table.getReader(position, 0);
+        for (int i = 0; i < options.blockSize; ++i) {
+            out[i] = reader.getSample(phase);
+            advance();
+        }
+    });
+}
+
+void benchWavetables(Runner& runner, const Options& options) {
+    synth::WavetableManager manager;
+    std::vector<float> out(options.blockSize);
+    for (const std::string& name : manager.getTableNames()) {
+        synth::WavetableOscillatorImpl osc;
+        osc.setWavetableManager(&manager);
+        osc.setSampleRate(options.sampleRate);
+        osc.setFrequency(220.0f);
+        osc.setType(static_cast<int>(Oscillator::WaveformType::Wavetable));
+        osc.selectWavetable(name);
+        osc.setWavetablePosition(0.5f);
+        runner.run("wavetable_oscillator", name, options.blockSize, [&]() {
+            osc.processBlock(out.data(), options.blockSize);
+        });
+    }
+
+    benchWavetableMorph(runner, options, *manager.getWavetable("PWM"));
+}
+
+void benchFilters(Runner& runner, const Options& options, const std::vector<float>& noise) {
+    static const struct {
+        Filter::FilterType type;
+        const char* name;
+    } types[] = {
+        {Filter::FilterType::LowPass, "lowpass"},
+        {Filter::FilterType::HighPass, "highpass"},
+        {Filter::FilterType::BandPass, "bandpass"},
+        {Filter::FilterType::Notch, "notch"},
+        {Filter::FilterType::LowShelf, "lowshelf"},
+        {Filter::FilterType::HighShelf, "highshelf"}
+    };
+
+    std::vector<float> work(options.blockSize);
+    for (const auto& type : types) {
+        Filter filter;
+        filter.setSampleRate(options.sampleRate);
+        filter.setType(static_cast<int>(type.type));
+        filter.setCutoff(1200.0f);
+        filter.setResonance(0.7f);
+        filter.setGain(2.0f);
+        runner.run("filter", type.name, options.blockSize, [&]() {
+            copyInput(noise, work);
+            filter.processBlock(work.data(), options.blockSize);
+        });
+    }
+}
+
+void benchEnvelopes(Runner& runner, const Options& options) {
+    static const struct {
+        Envelope::CurveType curve;
+        const char* name;
+    } curves[] = {
+        {Envelope::CurveType::Linear, "linear"},
+        {Envelope::CurveType::Exponential, "exponential"},
+        {Envelope::CurveType::Logarithmic, "logarithmic"},
+        {Envelope::CurveType::SCurve, "scurve"}
+    };
+
+    // One note per 0.4 s cycle, released halfway, so every stage is timed
+    const int cycleBlocks = std::max(2, static_cast<int>(options.sampleRate * 0.4f) / options.blockSize);
+    std::vector<float> out(options.blockSize);
+    for (const auto& curve : curves) {
+        Envelope envelope;
+        envelope.setSampleRate(options.sampleRate);
+        envelope.setAttack(0.02f);
+        envelope.setDecay(0.05f);
+        envelope.setSustain(0.6f);
+        envelope.setRelease(0.1f);
+        envelope.setAttackCurve(curve.curve);
+        envelope.setDecayCurve(curve.curve);
+        envelope.setReleaseCurve(curve.curve);
+        int blockIndex = 0;
+        runner.run("envelope", curve.name, options.blockSize, [&]() {
+            if (blockIndex == 0) {
+                envelope.noteOn(1.0f);
+            } else if (blockIndex == cycleBlocks / 2) {
+                envelope.noteOff();
+            }
+            blockIndex = (blockIndex + 1) % cycleBlocks;
+            envelope.processBlock(out.data(), options.blockSize);
+        });
+    }
+}
+
+void benchEffects(Runner& runner, const Options& options, const std::vector<float>& noise) {
+    std::vector<float> work(options.blockSize);
+
+    Delay delay;
+    delay.setSampleRate(options.sampleRate);
+    delay.setTime(0.35f);
+    delay.setFeedback(0.5f);
+    delay.setMix(0.5f);
+    runner.run("delay", "feedback_0.5", options.blockSize, [&]() {
+        copyInput(noise, work);
+        delay.processBlock(work.data(), options.blockSize);
+    });
+
+    Reverb reverb;
+    reverb.setSampleRate(options.sampleRate);
+    reverb.setDamping(0.5f);
+    reverb.setMix(0.5f);
+    runner.run("reverb", "mix_0.5", options.blockSize, [&]() {
+        copyInput(noise, work);
+        reverb.processBlock(work.data(), options.blockSize);
+    });
+}
+
+void benchGranular(Runner& runner, const Options& options, const std::vector<float>& noise) {
+    // Density is rate times duration: the mean number of overlapping grains
+    static const struct {
+        float rate;
+        float duration;
+        const char* name;
+    } densities[] = {
+        {10.0f, 0.05f, "rate_10_dur_50ms"},
+        {50.0f, 0.1f, "rate_50_dur_100ms"},
+        {100.0f, 0.25f, "rate_100_dur_250ms"},
+        {100.0f, 1.0f, "rate_100_dur_1000ms"}
+    };
+
+    std::vector<float> left(options.blockSize);
+    std::vector<float> right(options.blockSize);
+    for (const auto& density : densities) {
+        synth::GranularSynthesizer granular;
+        granular.setSampleRate(static_cast<float>(options.sampleRate));
+        granular.setBuffer(noise);
+        granular.setGrainRate(density.rate);
+        granular.setGrainDuration(density.duration);
+        granular.setPosition(0.25f);
+        granular.setPitch(1.5f);
+        runner.run("granular", density.name, options.blockSize, [&]() {
+            granular.processBlock(left.data(), right.data(), options.blockSize);
+        });
+    }
+}
+
+void benchEngine(Runner& runner, const Options& options) {
+    static const int blockSizes[] = {64, 256, 1024};
+    static const int notes[] = {48, 52, 55, 59, 60, 64, 67, 71};
+
+    for (int blockSize : blockSizes) {
+        SynthEngineHandle engine = CreateOfflineSynthEngine(options.sampleRate, 0.75f);
+        if (!engine) {
+            std::cerr << "Failed to create the engine" << std::endl;
+            continue;
+        }
+
+        // Eight held notes through the default patch with the effects on
+        EngineScheduleParameter(engine, SYNTH_PARAM_DELAY_FEEDBACK, 0.4f, 0);
+        EngineScheduleParameter(engine, SYNTH_PARAM_REVERB_MIX, 0.3f, 0);
+        for (int note : notes) {
+            EngineScheduleNoteOn(engine, note, 100, 0);
+        }
+
+        std::vector<float> buffer(static_cast<size_t>(blockSize) * 2);
+        runner.run("process_audio", "8_voices", blockSize, [&]() {
+            RenderFrames(engine, buffer.data(), blockSize);
+        });
+        DestroySynthEngine(engine);
+    }
+}
+
+// Scaling mode
+
+struct ScalingConfig {
+    int oscillators;
+    float grainRate;     // Grains per second, 0 with granular off
+    float grainDuration; // Seconds
+};
+
+/**
+ * Render a held chord through a fresh offline engine and time it.
+ *
+ * @return The mean wall time per block in microseconds, or a negative
+ *         value if the engine could not be set up
+ */
+double measureBlockUs(const Options& options, const ScalingConfig& config, int voices,
+                      const std::vector<float>& grainSource) {
+    SynthEngineHandle engine = CreateOfflineSynthEngine(options.sampleRate, 0.75f);
+    if (!engine) {
+        return -1.0;
+    }
+    if (options.threads != 1 && EngineSetRenderThreadCount(engine, options.threads) != 0) {
+        DestroySynthEngine(engine);
+        return -1.0;
+    }
+
+    EngineScheduleParameter(engine, SYNTH_PARAM_POLYPHONY, static_cast<float>(VoicePool::kMaxVoices), 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_OSCILLATOR_COUNT, static_cast<float>(config.oscillators), 0);
+    if (config.grainRate > 0.0f) {
+        EngineLoadGranularBuffer(engine, grainSource.data(), static_cast<int>(grainSource.size()));
+        EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_GRAIN_RATE, config.grainRate, 0);
+        EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_GRAIN_DURATION, config.grainDuration, 0);
+    }
+    for (int v = 0; v < voices; ++v) {
+        EngineScheduleNoteOn(engine, 36 + v, 100, 0);
+    }
+
+    // Past the attack, with the grain pool filled, before timing
+    std::vector<float> buffer(static_cast<size_t>(options.blockSize) * 2);
+    const int warmupBlocks = std::max(4, options.sampleRate / 4 / options.blockSize);
+    for (int b = 0; b < warmupBlocks; ++b) {
+        RenderFrames(engine, buffer.data(), options.blockSize);
+    }
+    if (EngineGetActiveVoiceCount(engine) != voices) {
+        DestroySynthEngine(engine);
+        return -1.0;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const int blocks = std::max(16, static_cast<int>(options.sampleRate * options.minTime) / options.blockSize);
+    const auto start = Clock::now();
+    for (int b = 0; b < blocks; ++b) {
+        RenderFrames(engine, buffer.data(), options.blockSize);
+    }
+    const double elapsedUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+    DestroySynthEngine(engine);
+    return elapsedUs / blocks;
+}
+
+int runScaling(const Options& options) {
+    static const int oscillatorCounts[] = {1, 2, 3, 4};
+    static const struct {
+        float rate;
+        float duration;
+    } densities[] = {
+        {0.0f, 0.0f},
+        {10.0f, 0.1f},
+        {50.0f, 0.2f},
+        {100.0f, 0.5f}
+    };
+
+    const double periodUs = 1.0e6 * options.blockSize / options.sampleRate;
+    const double budgetUs = periodUs * options.budget;
+    const std::vector<float> grainSource = makeNoise(static_cast<size_t>(options.sampleRate));
+
+    if (options.format == "table") {
+        std::printf("Buffer %d frames at %d Hz: %.1f us period, budget %.1f us (%.0f%%), %d render thread(s)\n\n",
+                    options.blockSize, options.sampleRate, periodUs, budgetUs, options.budget * 100.0,
+                    options.threads);
+        std::printf("%11s %14s %10s %12s %8s\n", "oscillators", "grains", "max voices", "us/block", "load");
+    } else if (options.format == "csv") {
+        std::printf("oscillators,grain_density,max_voices,at_limit,us_per_block,load\n");
+    }
+
+    bool failed = false;
+    for (int oscillators : oscillatorCounts) {
+        for (const auto& density : densities) {
+            const ScalingConfig config = {oscillators, density.rate, density.duration};
+
+            // Double the voice count until a block goes over the budget,
+            // then bisect between the last count that fit and that one
+            int fits = 0;
+            double fitsUs = 0.0;
+            int over = 0;
+            for (int voices = 1; voices <= VoicePool::kMaxVoices; voices *= 2) {
+                const double us = measureBlockUs(options, config, voices, grainSource);
+                if (us < 0.0) {
+                    failed = true;
+                    break;
+                }
+                if (us > budgetUs) {
+                    over = voices;
+                    break;
+                }
+                fits = voices;
+                fitsUs = us;
+            }
+            while (!failed && over > 0 && over - fits > 1) {
+                const int voices = (fits + over) / 2;
+                const double us = measureBlockUs(options, config, voices, grainSource);
+                if (us < 0.0) {
+                    failed = true;
+                } else if (us > budgetUs) {
+                    over = voices;
+                } else {
+                    fits = voices;
+                    fitsUs = us;
+                }
+            }
+            if (failed) {
+                std::cerr << "Failed to render " << oscillators << " oscillator(s)" << std::endl;
+                return 1;
+            }
+
+            // Mean number of overlapping grains
+            const double grainDensity = density.rate * density.duration;
+            const bool atLimit = over == 0;
+            const double load = fitsUs / periodUs;
+            if (options.format == "table") {
+                char voicesText[16];
+                std::snprintf(voicesText, sizeof(voicesText), "%d%s", fits, atLimit ? "+" : "");
+                std::printf("%11d %14s %10s %12.1f %8.2f\n", oscillators,
+                            grainDensity > 0.0 ? std::to_string(static_cast<int>(grainDensity)).c_str() : "off",
+                            voicesText, fitsUs, load);
+            } else if (options.format == "csv") {
+                std::printf("%d,%.1f,%d,%d,%.2f,%.4f\n", oscillators, grainDensity, fits,
+                            atLimit ? 1 : 0, fitsUs, load);
+            } else {
+                std::printf("{\"oscillators\":%d,\"grain_density\":%.1f,\"max_voices\":%d,"
+                            "\"at_limit\":%s,\"us_per_block\":%.2f,\"load\":%.4f}\n",
+                            oscillators, grainDensity, fits, atLimit ? "true" : "false", fitsUs, load);
+            }
+            std::fflush(stdout);
+        }
+    }
+
+    if (options.format == "table") {
+        std::printf("\n+ means the voice limit (%d) was reached within the budget\n", VoicePool::kMaxVoices);
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    if (options.mode == "scaling") {
+        return runScaling(options);
+    }
+
+    // One second of input for the processors and the granular source
+    const std::vector<float> noise = makeNoise(static_cast<size_t>(
+        std::max(options.sampleRate, options.blockSize)));
+
+    Runner runner(options);
+    benchOscillators(runner, options);
+    benchWavetables(runner, options);
+    benchFilters(runner, options, noise);
+    benchEnvelopes(runner, options);
+    benchEffects(runner, options, noise);
+    benchGranular(runner, options, noise);
+    benchEngine(runner, options);
+    return 0;
+}
@@ -19,10 +19,66 @@ extern "C" {
  * designed for use with Flutter FFI bindings.
  */
 
+// Audio callback timing, filled in by GetCallbackStats. Load is callback
+// time over buffer duration; 1.0 or more is an overrun. Histogram bin i
+// counts loads in [i * 0.1, (i + 1) * 0.1), the last bin everything above
+#ifndef SYNTH_CALLBACK_STATS_DEFINED
+#define SYNTH_CALLBACK_STATS_DEFINED
+#define SYNTH_LOAD_HISTOGRAM_BINS 20
+typedef struct SynthCallbackStats {
+    long long callbacks;
+    long long overruns;
+    double averageLoad;
+    double peakLoad;
+    double averageCallbackUs;
+    double maxCallbackUs;
+    long long histogram[SYNTH_LOAD_HISTOGRAM_BINS];
+} SynthCallbackStats;
+#endif
+
 // Engine lifecycle
 SYNTH_API int InitializeSynthEngine(int sampleRate, int bufferSize, float initialVolume);
 SYNTH_API void ShutdownSynthEngine();
 
+// Engine instances; every function below has an Engine-prefixed version
+// taking the handle first, e.g. EngineNoteOn(engine, note, velocity)
+typedef struct SynthEngineInstance* SynthEngineHandle;
+SYNTH_API SynthEngineHandle CreateSynthEngine(int sampleRate, int bufferSize, float initialVolume);
+SYNTH_API void DestroySynthEngine(SynthEngineHandle engine);
+SYNTH_API SynthEngineHandle GetDefaultSynthEngine();
+
+// Offline rendering without an audio device
+SYNTH_API SynthEngineHandle CreateOfflineSynthEngine(int sampleRate, float initialVolume);
+SYNTH_API int RenderFrames(SynthEngineHandle engine, float* out, int frames);
+SYNTH_API int EngineProcessMidiEvent(SynthEngineHandle engine, unsigned char status, unsigned char data1, unsigned char data2);
+SYNTH_API int EngineSetParameter(SynthEngineHandle engine, int parameterId, float value);
+SYNTH_API float EngineGetParameter(SynthEngineHandle engine, int parameterId);
+SYNTH_API int EngineNoteOn(SynthEngineHandle engine, int note, int velocity);
+SYNTH_API int EngineNoteOff(SynthEngineHandle engine, int note);
+SYNTH_API int EngineLoadGranularBuffer(SynthEngineHandle engine, const float* buffer, int length);
+SYNTH_API int EngineSetRandomSeed(SynthEngineHandle engine, unsigned int seed);
+SYNTH_API int EngineScheduleNoteOn(SynthEngineHandle engine, int note, int velocity, long long sampleTime);
+SYNTH_API int EngineScheduleNoteOff(SynthEngineHandle engine, int note, long long sampleTime);
+SYNTH_API int EngineScheduleParameter(SynthEngineHandle engine, int parameterId, float value, long long sampleTime);
+SYNTH_API long long EngineGetSampleTime(SynthEngineHandle engine);
+SYNTH_API int EngineGetActiveVoiceCount(SynthEngineHandle engine);
+SYNTH_API long long EngineGetVoiceStealCount(SynthEngineHandle engine);
+SYNTH_API long long EngineGetVoiceDropCount(SynthEngineHandle engine);
+SYNTH_API double EngineGetDspLoad(SynthEngineHandle engine);
+SYNTH_API int EngineGetCallbackStats(SynthEngineHandle engine, SynthCallbackStats* stats);
+SYNTH_API int EngineResetCallbackStats(SynthEngineHandle engine);
+SYNTH_API int EngineSetRenderThreadCount(SynthEngineHandle engine, int threads);
+SYNTH_API int EngineGetRenderThreadCount(SynthEngineHandle engine);
+SYNTH_API int EngineStartRecording(SynthEngineHandle engine, const char* path);
+SYNTH_API int EngineStopRecording(SynthEngineHandle engine);
+SYNTH_API long long EngineGetRecordedFrames(SynthEngineHandle engine);
+SYNTH_API long long EngineGetDroppedRecordingFrames(SynthEngineHandle engine);
+SYNTH_API double EngineGetBassLevel(SynthEngineHandle engine);
+SYNTH_API double EngineGetMidLevel(SynthEngineHandle engine);
+SYNTH_API double EngineGetHighLevel(SynthEngineHandle engine);
+SYNTH_API double EngineGetAmplitudeLevel(SynthEngineHandle engine);
+SYNTH_API double EngineGetDominantFrequency(SynthEngineHandle engine);
+
 // Note control
 SYNTH_API int NoteOn(int note, int velocity);
 SYNTH_API int NoteOff(int note);
@@ -34,6 +90,51 @@ SYNTH_API float GetParameter(int parameterId);
 
 // Granular synthesis
 SYNTH_API int LoadGranularBuffer(const float* buffer, int length);
+SYNTH_API int SetRandomSeed(unsigned int seed);
+
+// Sample-accurate event scheduling. Return 0 on success, -3 if the event
+// queue is full and -6 for a note or velocity outside 0-127, an unknown
+// parameter ID or a NaN value
+SYNTH_API int ScheduleNoteOn(int note, int velocity, long long sampleTime);
+SYNTH_API int ScheduleNoteOff(int note, long long sampleTime);
+SYNTH_API int ScheduleParameter(int parameterId, float value, long long sampleTime);
+SYNTH_API long long GetSampleTime();
+
+// Voice allocation statistics
+SYNTH_API int GetActiveVoiceCount();
+SYNTH_API long long GetVoiceStealCount();
+SYNTH_API long long GetVoiceDropCount();
+
+// DSP load meter
+SYNTH_API double GetDspLoad();
+SYNTH_API int GetCallbackStats(SynthCallbackStats* stats);
+SYNTH_API int ResetCallbackStats();
+
+// Multi-threaded voice rendering
+SYNTH_API int SetRenderThreadCount(int threads);
+SYNTH_API int GetRenderThreadCount();
+
+// Recording the master output to WAV
+SYNTH_API int StartRecording(const char* path);
+SYNTH_API int StopRecording();
+SYNTH_API long long GetRecordedFrames();
+SYNTH_API long long GetDroppedRecordingFrames();
+
+// Real-time safety checker (process-wide; -1 unless built with SYNTH_RT_SAFETY_CHECKS)
+SYNTH_API long long GetRtSafetyViolationCount();
+SYNTH_API void ResetRtSafetyViolations();
+SYNTH_API void PrintRtSafetyReport();
+
+// Render stage profiler (per engine and render thread; -1 unless built with
+// SYNTH_ENABLE_PROFILING). Pass thread -1 for the sum over all threads;
+// the functions without an engine read the default engine
+SYNTH_API int EngineGetProfileThreadCount(SynthEngineHandle engine);
+SYNTH_API int EngineGetProfileSnapshot(SynthEngineHandle engine, int thread, long long* nanoseconds, long long* calls, int numStages);
+SYNTH_API void EngineResetProfile(SynthEngineHandle engine);
+SYNTH_API int GetProfileThreadCount();
+SYNTH_API int GetProfileSnapshot(int thread, long long* nanoseconds, long long* calls, int numStages);
+SYNTH_API const char* GetProfileStageName(int stage);
+SYNTH_API void ResetProfile();
 
 // Audio analysis for visualization
 SYNTH_API double GetBassLevel();
@@ -45,6 +146,9 @@ SYNTH_API double GetDominantFrequency();
 // Parameter IDs (must match Dart parameter_definitions.dart)
 #define SYNTH_PARAM_MASTER_VOLUME        0
 #define SYNTH_PARAM_MASTER_MUTE          1
+#define SYNTH_PARAM_POLYPHONY            7
+#define SYNTH_PARAM_VOICE_STEAL_POLICY   8
+#define SYNTH_PARAM_PARAMETER_SMOOTHING  9
 #define SYNTH_PARAM_FILTER_CUTOFF        10
 #define SYNTH_PARAM_FILTER_RESONANCE     11
 #define SYNTH_PARAM_FILTER_TYPE          12
@@ -61,6 +165,53 @@ SYNTH_API double GetDominantFrequency();
 #define SYNTH_PARAM_GRANULAR_POSITION    43
 #define SYNTH_PARAM_GRANULAR_PITCH       44
 #define SYNTH_PARAM_GRANULAR_AMPLITUDE   45
+#define SYNTH_PARAM_GRANULAR_POSITION_VARIATION 46
+#define SYNTH_PARAM_GRANULAR_PITCH_VARIATION 47
+#define SYNTH_PARAM_GRANULAR_DURATION_VARIATION 48
+#define SYNTH_PARAM_GRANULAR_PAN         49
+#define SYNTH_PARAM_GRANULAR_PAN_VARIATION 50
+#define SYNTH_PARAM_OSCILLATOR_COUNT     90
+
+// Oscillator parameters; add (n * 10) for oscillator n. Wavetable index
+// 0-4 selects the built-in "Basic Shapes", "PWM", "Harmonic Series",
+// "Vocal Formants" and "Bell"; custom tables follow in the order added
+#define SYNTH_PARAM_OSCILLATOR_TYPE      100
+#define SYNTH_PARAM_OSCILLATOR_VOLUME    103
+#define SYNTH_PARAM_OSCILLATOR_WAVETABLE_INDEX 105
+#define SYNTH_PARAM_OSCILLATOR_WAVETABLE_POSITION 106
+
+// Modulation parameters; add (n * 2) for LFO n, (n * 4) for envelope n
+// and (n * 3) for route n. Routed to volume or filter parameters, the
+// modulation ramps across each 32-frame control block; routed to discrete
+// parameters (mute, polyphony, types, wavetable index) it steps
+#define SYNTH_PARAM_LFO_RATE             200
+#define SYNTH_PARAM_LFO_SHAPE            201
+#define SYNTH_PARAM_AUX_ENV_ATTACK       210
+#define SYNTH_PARAM_AUX_ENV_DECAY        211
+#define SYNTH_PARAM_AUX_ENV_SUSTAIN      212
+#define SYNTH_PARAM_AUX_ENV_RELEASE      213
+#define SYNTH_PARAM_MOD_ROUTE_SOURCE     220
+#define SYNTH_PARAM_MOD_ROUTE_DESTINATION 221
+#define SYNTH_PARAM_MOD_ROUTE_AMOUNT     222
+
+// Profiler stages (index into GetProfileSnapshot arrays)
+#define SYNTH_PROFILE_CONTROL            0
+#define SYNTH_PROFILE_MODULATION         1
+#define SYNTH_PROFILE_OSCILLATORS        2
+#define SYNTH_PROFILE_ENVELOPE           3
+#define SYNTH_PROFILE_FILTER             4
+#define SYNTH_PROFILE_GRANULAR           5
+#define SYNTH_PROFILE_DELAY              6
+#define SYNTH_PROFILE_REVERB             7
+#define SYNTH_PROFILE_OUTPUT             8
+#define SYNTH_PROFILE_ANALYSIS           9
+#define SYNTH_PROFILE_STAGE_COUNT        10
+
+// Voice steal policies (SYNTH_PARAM_VOICE_STEAL_POLICY)
+#define SYNTH_STEAL_SAME_NOTE            0
+#define SYNTH_STEAL_OLDEST               1
+#define SYNTH_STEAL_QUIETEST             2
+#define SYNTH_STEAL_NONE                 3
 
 #ifdef __cplusplus
 }
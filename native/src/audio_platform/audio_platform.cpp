@@ -1,5 +1,11 @@
 #include "audio_platform.h"
+#include "audio_platform_null.h"
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(SYNTH_NO_RTAUDIO)
 #include "audio_platform_rtaudio.h"
+#endif
 
 #if defined(__ANDROID__)
 // #include "audio_platform_android.h"
@@ -12,7 +18,21 @@
 
 // Factory method to create a platform-specific audio implementation
 std::unique_ptr<AudioPlatform> AudioPlatform::createForCurrentPlatform() {
-#if defined(__ANDROID__)
+    // SYNTH_AUDIO_PLATFORM=null (timer paced) or null-freerun runs the
+    // engine without a sound card, e.g. on servers and in tests
+    if (const char* backend = std::getenv("SYNTH_AUDIO_PLATFORM")) {
+        if (std::strcmp(backend, "null") == 0) {
+            return std::make_unique<NullAudioPlatform>(NullAudioPlatform::Mode::Realtime);
+        }
+        if (std::strcmp(backend, "null-freerun") == 0) {
+            return std::make_unique<NullAudioPlatform>(NullAudioPlatform::Mode::FreeRunning);
+        }
+    }
+    
+#if defined(SYNTH_NO_RTAUDIO)
+    // Built without a device backend
+    return std::make_unique<NullAudioPlatform>();
+#elif defined(__ANDROID__)
     // Return Android implementation when we have it
     // return std::make_unique<AndroidAudioPlatform>();
     return std::make_unique<RTAudioPlatform>();
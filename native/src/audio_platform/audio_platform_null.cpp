@@ -0,0 +1,153 @@
+#include "audio_platform_null.h"
+#include "synthesis/denormals.h"
+#include <algorithm>
+#include <chrono>
+
+NullAudioPlatform::NullAudioPlatform(Mode m) : mode(m) {}
+
+NullAudioPlatform::~NullAudioPlatform() {
+    stop();
+}
+
+bool NullAudioPlatform::initialize(int sr, int bs, int nc, AudioCallback cb) {
+    if (initialized) {
+        return true; // Already initialized
+    }
+
+    if (sr <= 0 || bs <= 0 || nc <= 0) {
+        lastError = "Invalid stream configuration";
+        return false;
+    }
+
+    sampleRate = sr;
+    bufferSize = bs;
+    numChannels = nc;
+    callback = cb;
+
+    // Allocated once; the callback thread never allocates
+    buffer.assign(static_cast<size_t>(bufferSize) * numChannels, 0.0f);
+
+    initialized = true;
+    return true;
+}
+
+bool NullAudioPlatform::start() {
+    if (!initialized) {
+        lastError = "Cannot start: not initialized";
+        return false;
+    }
+
+    if (running) {
+        return true; // Already running
+    }
+
+    callbackCount = 0;
+    overrunCount = 0;
+    jitterSumNs = 0;
+    jitterMaxNs = 0;
+    callbackSumNs = 0;
+    callbackMaxNs = 0;
+
+    try {
+        running = true;
+        thread = std::thread(&NullAudioPlatform::run, this);
+        return true;
+    } catch (const std::exception& e) {
+        running = false;
+        lastError = e.what();
+        return false;
+    }
+}
+
+bool NullAudioPlatform::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+    return true;
+}
+
+int NullAudioPlatform::getSampleRate() const {
+    return sampleRate;
+}
+
+int NullAudioPlatform::getBufferSize() const {
+    return bufferSize;
+}
+
+int NullAudioPlatform::getNumOutputChannels() const {
+    return numChannels;
+}
+
+bool NullAudioPlatform::isInitialized() const {
+    return initialized;
+}
+
+bool NullAudioPlatform::isRunning() const {
+    return running;
+}
+
+std::string NullAudioPlatform::getLastError() const {
+    return lastError;
+}
+
+NullAudioPlatform::TimingStats NullAudioPlatform::getTimingStats() const {
+    TimingStats stats;
+    stats.callbacks = callbackCount.load(std::memory_order_relaxed);
+    stats.overruns = overrunCount.load(std::memory_order_relaxed);
+    if (stats.callbacks > 0) {
+        const double count = static_cast<double>(stats.callbacks);
+        stats.meanJitterUs = jitterSumNs.load(std::memory_order_relaxed) / count / 1000.0;
+        stats.meanCallbackUs = callbackSumNs.load(std::memory_order_relaxed) / count / 1000.0;
+    }
+    stats.maxJitterUs = jitterMaxNs.load(std::memory_order_relaxed) / 1000.0;
+    stats.maxCallbackUs = callbackMaxNs.load(std::memory_order_relaxed) / 1000.0;
+    return stats;
+}
+
+void NullAudioPlatform::run() {
+    // The thread only ever runs the callback, so set the FPU mode once
+    ScopedDenormalsDisabled noDenormals;
+    
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(bufferSize) / sampleRate));
+
+    auto deadline = Clock::now() + period;
+    while (running.load(std::memory_order_relaxed)) {
+        uint64_t jitterNs = 0;
+        if (mode == Mode::Realtime) {
+            std::this_thread::sleep_until(deadline);
+            jitterNs = static_cast<uint64_t>(std::max<int64_t>(0,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - deadline).count()));
+        }
+
+        const auto callbackStart = Clock::now();
+        if (callback) {
+            callback(buffer.data(), bufferSize, numChannels);
+        }
+        const auto callbackEnd = Clock::now();
+        const auto callbackNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(callbackEnd - callbackStart).count());
+
+        callbackCount.store(callbackCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        jitterSumNs.store(jitterSumNs.load(std::memory_order_relaxed) + jitterNs, std::memory_order_relaxed);
+        callbackSumNs.store(callbackSumNs.load(std::memory_order_relaxed) + callbackNs, std::memory_order_relaxed);
+        if (jitterNs > jitterMaxNs.load(std::memory_order_relaxed)) {
+            jitterMaxNs.store(jitterNs, std::memory_order_relaxed);
+        }
+        if (callbackNs > callbackMaxNs.load(std::memory_order_relaxed)) {
+            callbackMaxNs.store(callbackNs, std::memory_order_relaxed);
+        }
+
+        if (mode == Mode::Realtime) {
+            deadline += period;
+            if (callbackEnd > deadline) {
+                // A device would have underrun here; resynchronize instead
+                // of firing a burst of late callbacks
+                overrunCount.store(overrunCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                deadline = callbackEnd;
+            }
+        }
+    }
+}
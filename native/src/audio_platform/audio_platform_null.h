@@ -0,0 +1,89 @@
+#ifndef AUDIO_PLATFORM_NULL_H
+#define AUDIO_PLATFORM_NULL_H
+
+#include "audio_platform.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/**
+ * Audio platform without a device.
+ *
+ * A dedicated thread calls the audio callback at the configured buffer
+ * size and discards the output. In realtime mode the calls are paced by a
+ * high-resolution timer, one buffer period apart, so the engine runs
+ * exactly as it would on a sound card; in free-running mode they follow
+ * each other back to back. Used on servers, in tests, and in builds
+ * without RtAudio.
+ */
+class NullAudioPlatform : public AudioPlatform {
+public:
+    enum class Mode {
+        Realtime,   // One callback per buffer period
+        FreeRunning // Callbacks back to back, as fast as the CPU allows
+    };
+
+    /**
+     * Timing of the callbacks since start().
+     *
+     * Jitter is how late the callback thread woke up relative to its
+     * deadline; it is zero in free-running mode.
+     */
+    struct TimingStats {
+        uint64_t callbacks = 0;
+        uint64_t overruns = 0;       // Callbacks that finished after the next deadline
+        double meanJitterUs = 0.0;
+        double maxJitterUs = 0.0;
+        double meanCallbackUs = 0.0;
+        double maxCallbackUs = 0.0;
+    };
+
+    explicit NullAudioPlatform(Mode mode = Mode::Realtime);
+    ~NullAudioPlatform() override;
+
+    bool initialize(int sampleRate, int bufferSize, int numChannels, AudioCallback callback) override;
+    bool start() override;
+    bool stop() override;
+    int getSampleRate() const override;
+    int getBufferSize() const override;
+    int getNumOutputChannels() const override;
+    bool isInitialized() const override;
+    bool isRunning() const override;
+    std::string getLastError() const override;
+
+    Mode getMode() const {
+        return mode;
+    }
+
+    /**
+     * Get the callback timing measured so far. Safe to call from any thread.
+     *
+     * @return The timing statistics
+     */
+    TimingStats getTimingStats() const;
+
+private:
+    void run();
+
+    Mode mode;
+    bool initialized = false;
+    std::atomic<bool> running{false};
+    int sampleRate = 44100;
+    int bufferSize = 512;
+    int numChannels = 2;
+    std::string lastError;
+    AudioCallback callback;
+    std::vector<float> buffer;
+    std::thread thread;
+
+    // Written by the callback thread only
+    std::atomic<uint64_t> callbackCount{0};
+    std::atomic<uint64_t> overrunCount{0};
+    std::atomic<uint64_t> jitterSumNs{0};
+    std::atomic<uint64_t> jitterMaxNs{0};
+    std::atomic<uint64_t> callbackSumNs{0};
+    std::atomic<uint64_t> callbackMaxNs{0};
+};
+
+#endif // AUDIO_PLATFORM_NULL_H
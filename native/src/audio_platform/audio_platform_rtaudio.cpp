@@ -1,5 +1,7 @@
 #include "audio_platform_rtaudio.h"
 #include "RtAudio.h"
+#include "synthesis/denormals.h"
+#include "rt_safety.h"
 #include <iostream>
 #include <vector>
 #include <stdexcept>
@@ -7,6 +9,9 @@
 // RtAudio callback function
 int rtaudioCallback(void* outputBuffer, void* /*inputBuffer*/, unsigned int nFrames,
                    double /*streamTime*/, RtAudioStreamStatus status, void* userData) {
+    ScopedDenormalsDisabled noDenormals;
+    SYNTH_RT_AUDIO_THREAD("rtaudioCallback");
+    
     if (status) {
         std::cerr << "Stream underflow detected!" << std::endl;
     }
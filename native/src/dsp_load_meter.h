@@ -0,0 +1,196 @@
+#ifndef DSP_LOAD_METER_H
+#define DSP_LOAD_METER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Snapshot of the audio callback timing, as returned by DspLoadMeter.
+ *
+ * Load is the wall time spent in a callback divided by the audio it
+ * produced: 1.0 means the callback took as long as its buffer lasts, and
+ * anything at or above that is an overrun that a device plays as a glitch.
+ */
+struct CallbackStats {
+    static constexpr int kHistogramBins = 20;
+    static constexpr double kHistogramBinWidth = 0.1; // Load per bin
+
+    uint64_t callbacks = 0;
+    uint64_t overruns = 0;          // Callbacks with a load of 1.0 or more
+    double averageLoad = 0.0;       // Total callback time over total audio time
+    double peakLoad = 0.0;
+    double averageCallbackUs = 0.0;
+    double maxCallbackUs = 0.0;
+
+    // Bin i counts callbacks with a load in [i * 0.1, (i + 1) * 0.1); the
+    // last bin also takes everything above
+    std::array<uint64_t, kHistogramBins> histogram{};
+};
+
+/**
+ * Measures how much of each buffer period the audio callback uses.
+ *
+ * The audio thread is the only writer; every counter is an atomic that it
+ * updates with plain relaxed stores, so the meter never locks or waits and
+ * any thread can read it at any time. A reset is requested from the
+ * control side and carried out by the audio thread at its next callback.
+ */
+class DspLoadMeter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Times one callback from construction to destruction.
+     */
+    class Scope {
+    public:
+        Scope(DspLoadMeter& meter, int numFrames)
+            : meter(meter), numFrames(numFrames), start(Clock::now()) {}
+
+        ~Scope() {
+            meter.addCallback(Clock::now() - start, numFrames);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        DspLoadMeter& meter;
+        const int numFrames;
+        const Clock::time_point start;
+    };
+
+    /**
+     * Set the sample rate the buffer period is derived from. Call before
+     * the audio thread starts.
+     */
+    void setSampleRate(int sampleRate) {
+        nsPerFrame = sampleRate > 0 ? 1.0e9 / sampleRate : 0.0;
+    }
+
+    /**
+     * Record one callback. Audio thread only.
+     *
+     * @param elapsed The wall time the callback took
+     * @param numFrames The frames it produced
+     */
+    void addCallback(Clock::duration elapsed, int numFrames) {
+        if (resetRequested.exchange(false, std::memory_order_acquire)) {
+            clear();
+        }
+
+        const uint64_t busyNs = static_cast<uint64_t>(
+            std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        const uint64_t periodNs = static_cast<uint64_t>(numFrames * nsPerFrame);
+        if (periodNs == 0) {
+            return;
+        }
+        const double load = static_cast<double>(busyNs) / static_cast<double>(periodNs);
+
+        increment(callbacks, 1);
+        increment(totalBusyNs, busyNs);
+        increment(totalPeriodNs, periodNs);
+        if (load >= 1.0) {
+            increment(overruns, 1);
+        }
+        if (busyNs > maxBusyNs.load(std::memory_order_relaxed)) {
+            maxBusyNs.store(busyNs, std::memory_order_relaxed);
+        }
+        if (load > peakLoad.load(std::memory_order_relaxed)) {
+            peakLoad.store(load, std::memory_order_relaxed);
+        }
+
+        const int bin = std::min(static_cast<int>(load / CallbackStats::kHistogramBinWidth),
+                                 CallbackStats::kHistogramBins - 1);
+        increment(histogram[bin], 1);
+
+        // Smoothed over roughly the last 20 callbacks
+        const double previous = currentLoad.load(std::memory_order_relaxed);
+        currentLoad.store(previous + (load - previous) * kSmoothing, std::memory_order_relaxed);
+    }
+
+    /**
+     * Get the recent DSP load. Safe to call from any thread.
+     *
+     * @return The smoothed load, 0.0 - 1.0 and above when overrunning
+     */
+    double getLoad() const {
+        return currentLoad.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Get the statistics since the last reset. Safe to call from any
+     * thread; the fields are read one by one, so a snapshot taken while
+     * the audio thread runs may straddle a callback.
+     *
+     * @return The statistics
+     */
+    CallbackStats getStats() const {
+        CallbackStats stats;
+        stats.callbacks = callbacks.load(std::memory_order_relaxed);
+        stats.overruns = overruns.load(std::memory_order_relaxed);
+        const uint64_t periodNs = totalPeriodNs.load(std::memory_order_relaxed);
+        const uint64_t busyNs = totalBusyNs.load(std::memory_order_relaxed);
+        if (periodNs > 0) {
+            stats.averageLoad = static_cast<double>(busyNs) / static_cast<double>(periodNs);
+        }
+        if (stats.callbacks > 0) {
+            stats.averageCallbackUs = static_cast<double>(busyNs) / stats.callbacks / 1000.0;
+        }
+        stats.peakLoad = peakLoad.load(std::memory_order_relaxed);
+        stats.maxCallbackUs = maxBusyNs.load(std::memory_order_relaxed) / 1000.0;
+        for (int i = 0; i < CallbackStats::kHistogramBins; ++i) {
+            stats.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    /**
+     * Ask the audio thread to clear the statistics at its next callback.
+     * Safe to call from any thread.
+     */
+    void requestReset() {
+        resetRequested.store(true, std::memory_order_release);
+    }
+
+    /**
+     * Clear the statistics immediately. Only while no callback can run.
+     */
+    void clear() {
+        callbacks.store(0, std::memory_order_relaxed);
+        overruns.store(0, std::memory_order_relaxed);
+        totalBusyNs.store(0, std::memory_order_relaxed);
+        totalPeriodNs.store(0, std::memory_order_relaxed);
+        maxBusyNs.store(0, std::memory_order_relaxed);
+        peakLoad.store(0.0, std::memory_order_relaxed);
+        currentLoad.store(0.0, std::memory_order_relaxed);
+        for (auto& bin : histogram) {
+            bin.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static constexpr double kSmoothing = 0.05;
+
+    // Single writer, so a relaxed load and store is enough
+    static void increment(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    double nsPerFrame = 0.0;
+    std::atomic<bool> resetRequested{false};
+
+    std::atomic<uint64_t> callbacks{0};
+    std::atomic<uint64_t> overruns{0};
+    std::atomic<uint64_t> totalBusyNs{0};
+    std::atomic<uint64_t> totalPeriodNs{0};
+    std::atomic<uint64_t> maxBusyNs{0};
+    std::atomic<double> peakLoad{0.0};
+    std::atomic<double> currentLoad{0.0};
+    std::array<std::atomic<uint64_t>, CallbackStats::kHistogramBins> histogram{};
+};
+
+#endif // DSP_LOAD_METER_H
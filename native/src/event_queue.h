@@ -0,0 +1,102 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+/**
+ * An event to be applied by the audio thread at a given sample time.
+ */
+struct ScheduledEvent {
+    enum class Type : uint8_t {
+        NoteOn,
+        NoteOff,
+        Parameter
+    };
+
+    uint64_t sampleTime = 0; // Engine sample clock frame to apply the event at
+    uint64_t sequence = 0;   // Push order, keeps equal timestamps first-in first-out
+    Type type = Type::NoteOn;
+    int id = 0;              // MIDI note or parameter ID
+    float value = 0.0f;      // Velocity (0-127) or parameter value
+};
+
+/**
+ * Fixed-capacity priority queue of scheduled events, ordered by sample time.
+ *
+ * Storage is preallocated, so pushing and popping never allocate and the
+ * queue can be drained on the audio thread. Events with the same sample
+ * time come out in the order they were pushed.
+ */
+class EventQueue {
+public:
+    static constexpr int kCapacity = 1024;
+
+    /**
+     * Add an event.
+     *
+     * @param event The event; its sequence number is assigned here
+     * @return True on success, false if the queue is full
+     */
+    bool push(ScheduledEvent event) {
+        if (count >= kCapacity) {
+            return false;
+        }
+        event.sequence = nextSequence++;
+        heap[count++] = event;
+        std::push_heap(heap.begin(), heap.begin() + count, later);
+        return true;
+    }
+
+    /**
+     * Get the sample time of the earliest event.
+     *
+     * @param sampleTime Receives the time if the queue is not empty
+     * @return True if there is an event, false if the queue is empty
+     */
+    bool peekTime(uint64_t& sampleTime) const {
+        if (count == 0) {
+            return false;
+        }
+        sampleTime = heap[0].sampleTime;
+        return true;
+    }
+
+    /**
+     * Remove and return the earliest event. The queue must not be empty.
+     *
+     * @return The earliest event
+     */
+    ScheduledEvent pop() {
+        std::pop_heap(heap.begin(), heap.begin() + count, later);
+        return heap[--count];
+    }
+
+    int size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+private:
+    // Heap order: the earliest event, then the first pushed, sits on top
+    static bool later(const ScheduledEvent& a, const ScheduledEvent& b) {
+        if (a.sampleTime != b.sampleTime) {
+            return a.sampleTime > b.sampleTime;
+        }
+        return a.sequence > b.sequence;
+    }
+
+    std::array<ScheduledEvent, kCapacity> heap;
+    int count = 0;
+    uint64_t nextSequence = 0;
+};
+
+#endif // EVENT_QUEUE_H
@@ -1,9 +1,27 @@
 #include "ffi_bridge.h"
+#include "synth_engine_api.h"
 #include "synth_engine.h"
+#include "rt_safety.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <memory>
 
 // Implementation of the FFI bridge functions
 
+namespace {
+
+SynthEngine* fromHandle(SynthEngineHandle handle) {
+    return reinterpret_cast<SynthEngine*>(handle);
+}
+
+SynthEngineHandle defaultHandle() {
+    return reinterpret_cast<SynthEngineHandle>(&SynthEngine::getInstance());
+}
+
+} // namespace
+
 int InitializeSynthEngine(int sampleRate, int bufferSize, float initialVolume) {
     try {
         SynthEngine& engine = SynthEngine::getInstance();
@@ -32,115 +50,196 @@ void ShutdownSynthEngine() {
     }
 }
 
-int ProcessMidiEvent(unsigned char status, unsigned char data1, unsigned char data2) {
+// Engine instances
+SynthEngineHandle CreateSynthEngine(int sampleRate, int bufferSize, float initialVolume) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        auto engine = std::make_unique<SynthEngine>();
+        if (!engine->initialize(sampleRate, bufferSize, initialVolume)) {
+            return nullptr; // Failed to initialize
+        }
+        return reinterpret_cast<SynthEngineHandle>(engine.release());
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in CreateSynthEngine: " << e.what() << std::endl;
+        return nullptr;
+    } catch (...) {
+        std::cerr << "Unknown exception in CreateSynthEngine" << std::endl;
+        return nullptr;
+    }
+}
+
+void DestroySynthEngine(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || engine == &SynthEngine::getInstance()) {
+            return; // The shared engine is stopped with ShutdownSynthEngine
+        }
+        delete engine; // Shuts the engine down
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in DestroySynthEngine: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unknown exception in DestroySynthEngine" << std::endl;
+    }
+}
+
+SynthEngineHandle CreateOfflineSynthEngine(int sampleRate, float initialVolume) {
+    try {
+        // The buffer size only sizes device callbacks; any value works offline
+        auto engine = std::make_unique<SynthEngine>();
+        if (!engine->initialize(sampleRate, 512, initialVolume, false)) {
+            return nullptr; // Failed to initialize
+        }
+        return reinterpret_cast<SynthEngineHandle>(engine.release());
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in CreateOfflineSynthEngine: " << e.what() << std::endl;
+        return nullptr;
+    } catch (...) {
+        std::cerr << "Unknown exception in CreateOfflineSynthEngine" << std::endl;
+        return nullptr;
+    }
+}
+
+int RenderFrames(SynthEngineHandle handle, float* out, int frames) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return -1; // Engine not initialized
         }
+        if (!out || frames < 0) {
+            return -2; // Invalid parameters
+        }
         
-        if (engine.processMidiEvent(status, data1, data2)) {
+        if (engine->renderFrames(out, frames)) {
+            return 0; // Success
+        } else {
+            return -3; // Engine drives an audio device
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in RenderFrames: " << e.what() << std::endl;
+        return -4; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in RenderFrames" << std::endl;
+        return -5; // Unknown exception
+    }
+}
+
+SynthEngineHandle GetDefaultSynthEngine() {
+    try {
+        return defaultHandle();
+    } catch (...) {
+        std::cerr << "Unknown exception in GetDefaultSynthEngine" << std::endl;
+        return nullptr;
+    }
+}
+
+int EngineProcessMidiEvent(SynthEngineHandle handle, unsigned char status, unsigned char data1, unsigned char data2) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        
+        if (engine->processMidiEvent(status, data1, data2)) {
             return 0; // Success
         } else {
             return -2; // Failed to process event
         }
     } catch (const std::exception& e) {
-        std::cerr << "Exception in ProcessMidiEvent: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineProcessMidiEvent: " << e.what() << std::endl;
         return -3; // Exception occurred
     } catch (...) {
-        std::cerr << "Unknown exception in ProcessMidiEvent" << std::endl;
+        std::cerr << "Unknown exception in EngineProcessMidiEvent" << std::endl;
         return -4; // Unknown exception
     }
 }
 
-int SetParameter(int parameterId, float value) {
+int EngineSetParameter(SynthEngineHandle handle, int parameterId, float value) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return -1; // Engine not initialized
         }
         
-        if (engine.setParameter(parameterId, value)) {
+        if (engine->setParameter(parameterId, value)) {
             return 0; // Success
         } else {
             return -2; // Failed to set parameter
         }
     } catch (const std::exception& e) {
-        std::cerr << "Exception in SetParameter: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineSetParameter: " << e.what() << std::endl;
         return -3; // Exception occurred
     } catch (...) {
-        std::cerr << "Unknown exception in SetParameter" << std::endl;
+        std::cerr << "Unknown exception in EngineSetParameter" << std::endl;
         return -4; // Unknown exception
     }
 }
 
-float GetParameter(int parameterId) {
+float EngineGetParameter(SynthEngineHandle handle, int parameterId) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return 0.0f; // Engine not initialized, return default
         }
         
-        return engine.getParameter(parameterId);
+        return engine->getParameter(parameterId);
     } catch (const std::exception& e) {
-        std::cerr << "Exception in GetParameter: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineGetParameter: " << e.what() << std::endl;
         return 0.0f; // Exception occurred, return default
     } catch (...) {
-        std::cerr << "Unknown exception in GetParameter" << std::endl;
+        std::cerr << "Unknown exception in EngineGetParameter" << std::endl;
         return 0.0f; // Unknown exception, return default
     }
 }
 
-int NoteOn(int note, int velocity) {
+int EngineNoteOn(SynthEngineHandle handle, int note, int velocity) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return -1; // Engine not initialized
         }
         
-        if (engine.noteOn(note, velocity)) {
+        if (engine->noteOn(note, velocity)) {
             return 0; // Success
         } else {
             return -2; // Failed to process note-on
         }
     } catch (const std::exception& e) {
-        std::cerr << "Exception in NoteOn: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineNoteOn: " << e.what() << std::endl;
         return -3; // Exception occurred
     } catch (...) {
-        std::cerr << "Unknown exception in NoteOn" << std::endl;
+        std::cerr << "Unknown exception in EngineNoteOn" << std::endl;
         return -4; // Unknown exception
     }
 }
 
-int NoteOff(int note) {
+int EngineNoteOff(SynthEngineHandle handle, int note) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return -1; // Engine not initialized
         }
         
-        if (engine.noteOff(note)) {
+        if (engine->noteOff(note)) {
             return 0; // Success
         } else {
             return -2; // Failed to process note-off
         }
     } catch (const std::exception& e) {
-        std::cerr << "Exception in NoteOff: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineNoteOff: " << e.what() << std::endl;
         return -3; // Exception occurred
     } catch (...) {
-        std::cerr << "Unknown exception in NoteOff" << std::endl;
+        std::cerr << "Unknown exception in EngineNoteOff" << std::endl;
         return -4; // Unknown exception
     }
 }
 
-int LoadGranularBuffer(const float* buffer, int length) {
+int EngineLoadGranularBuffer(SynthEngineHandle handle, const float* buffer, int length) {
     try {
         if (!buffer || length <= 0) {
             return -1; // Invalid parameters
         }
         
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return -2; // Engine not initialized
         }
         
@@ -148,97 +247,623 @@ int LoadGranularBuffer(const float* buffer, int length) {
         std::vector<float> audioData(buffer, buffer + length);
         
         // Load into granular synth through engine
-        if (engine.loadGranularBuffer(audioData)) {
+        if (engine->loadGranularBuffer(audioData)) {
             return 0; // Success
         } else {
             return -3; // Failed to load buffer
         }
     } catch (const std::exception& e) {
-        std::cerr << "Exception in LoadGranularBuffer: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineLoadGranularBuffer: " << e.what() << std::endl;
+        return -4; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineLoadGranularBuffer" << std::endl;
+        return -5; // Unknown exception
+    }
+}
+
+int EngineSetRandomSeed(SynthEngineHandle handle, unsigned int seed) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        
+        if (engine->setRandomSeed(static_cast<uint32_t>(seed))) {
+            return 0; // Success
+        } else {
+            return -2; // Command queue full
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineSetRandomSeed: " << e.what() << std::endl;
+        return -3; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineSetRandomSeed" << std::endl;
+        return -4; // Unknown exception
+    }
+}
+
+// Sample-accurate event scheduling
+int EngineScheduleNoteOn(SynthEngineHandle handle, int note, int velocity, long long sampleTime) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        if (sampleTime < 0) {
+            return -2; // Invalid sample time
+        }
+        if (!SynthEngine::isValidNote(note, velocity)) {
+            return -6; // Invalid note or velocity
+        }
+        
+        if (engine->scheduleNoteOn(note, velocity, static_cast<uint64_t>(sampleTime))) {
+            return 0; // Success
+        } else {
+            return -3; // Event queue full
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineScheduleNoteOn: " << e.what() << std::endl;
+        return -4; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineScheduleNoteOn" << std::endl;
+        return -5; // Unknown exception
+    }
+}
+
+int EngineScheduleNoteOff(SynthEngineHandle handle, int note, long long sampleTime) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        if (sampleTime < 0) {
+            return -2; // Invalid sample time
+        }
+        if (!SynthEngine::isValidNote(note)) {
+            return -6; // Invalid note
+        }
+        
+        if (engine->scheduleNoteOff(note, static_cast<uint64_t>(sampleTime))) {
+            return 0; // Success
+        } else {
+            return -3; // Event queue full
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineScheduleNoteOff: " << e.what() << std::endl;
+        return -4; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineScheduleNoteOff" << std::endl;
+        return -5; // Unknown exception
+    }
+}
+
+int EngineScheduleParameter(SynthEngineHandle handle, int parameterId, float value, long long sampleTime) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        if (sampleTime < 0) {
+            return -2; // Invalid sample time
+        }
+        if (!engine->isParameterId(parameterId) || std::isnan(value)) {
+            return -6; // Unknown parameter or invalid value
+        }
+        
+        if (engine->scheduleParameter(parameterId, value, static_cast<uint64_t>(sampleTime))) {
+            return 0; // Success
+        } else {
+            return -3; // Event queue full
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineScheduleParameter: " << e.what() << std::endl;
+        return -4; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineScheduleParameter" << std::endl;
+        return -5; // Unknown exception
+    }
+}
+
+long long EngineGetSampleTime(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return 0; // Engine not initialized
+        }
+        return static_cast<long long>(engine->getSampleTime());
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineGetSampleTime: " << e.what() << std::endl;
+        return 0;
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineGetSampleTime" << std::endl;
+        return 0;
+    }
+}
+
+// Voice allocation statistics
+int EngineGetActiveVoiceCount(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return 0; // Engine not initialized
+        }
+        return engine->getActiveVoiceCount();
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineGetActiveVoiceCount: " << e.what() << std::endl;
+        return 0;
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineGetActiveVoiceCount" << std::endl;
+        return 0;
+    }
+}
+
+long long EngineGetVoiceStealCount(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return 0; // Engine not initialized
+        }
+        return static_cast<long long>(engine->getVoiceStealCount());
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineGetVoiceStealCount: " << e.what() << std::endl;
+        return 0;
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineGetVoiceStealCount" << std::endl;
+        return 0;
+    }
+}
+
+long long EngineGetVoiceDropCount(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return 0; // Engine not initialized
+        }
+        return static_cast<long long>(engine->getVoiceDropCount());
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineGetVoiceDropCount: " << e.what() << std::endl;
+        return 0;
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineGetVoiceDropCount" << std::endl;
+        return 0;
+    }
+}
+
+// DSP load meter
+double EngineGetDspLoad(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return 0.0; // Engine not initialized
+        }
+        return engine->getDspLoad();
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineGetDspLoad: " << e.what() << std::endl;
+        return 0.0;
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineGetDspLoad" << std::endl;
+        return 0.0;
+    }
+}
+
+int EngineGetCallbackStats(SynthEngineHandle handle, SynthCallbackStats* stats) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        if (!stats) {
+            return -2; // Invalid output pointer
+        }
+        
+        const CallbackStats snapshot = engine->getCallbackStats();
+        stats->callbacks = static_cast<long long>(snapshot.callbacks);
+        stats->overruns = static_cast<long long>(snapshot.overruns);
+        stats->averageLoad = snapshot.averageLoad;
+        stats->peakLoad = snapshot.peakLoad;
+        stats->averageCallbackUs = snapshot.averageCallbackUs;
+        stats->maxCallbackUs = snapshot.maxCallbackUs;
+        static_assert(SYNTH_LOAD_HISTOGRAM_BINS == CallbackStats::kHistogramBins, "histogram size mismatch");
+        for (int i = 0; i < SYNTH_LOAD_HISTOGRAM_BINS; ++i) {
+            stats->histogram[i] = static_cast<long long>(snapshot.histogram[i]);
+        }
+        return 0; // Success
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineGetCallbackStats: " << e.what() << std::endl;
+        return -3; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineGetCallbackStats" << std::endl;
+        return -4; // Unknown exception
+    }
+}
+
+int EngineResetCallbackStats(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        engine->resetCallbackStats();
+        return 0; // Success
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineResetCallbackStats: " << e.what() << std::endl;
+        return -2; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineResetCallbackStats" << std::endl;
+        return -3; // Unknown exception
+    }
+}
+
+// Multi-threaded voice rendering
+int EngineSetRenderThreadCount(SynthEngineHandle handle, int threads) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        
+        if (engine->setRenderThreadCount(threads)) {
+            return 0; // Success
+        } else {
+            return -2; // Invalid thread count
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineSetRenderThreadCount: " << e.what() << std::endl;
+        return -3; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineSetRenderThreadCount" << std::endl;
+        return -4; // Unknown exception
+    }
+}
+
+int EngineGetRenderThreadCount(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return 0; // Engine not initialized
+        }
+        return engine->getRenderThreadCount();
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineGetRenderThreadCount: " << e.what() << std::endl;
+        return 0;
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineGetRenderThreadCount" << std::endl;
+        return 0;
+    }
+}
+
+// Recording
+int EngineStartRecording(SynthEngineHandle handle, const char* path) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        if (!path || !*path) {
+            return -2; // Invalid path
+        }
+        
+        if (engine->startRecording(path)) {
+            return 0; // Success
+        } else {
+            return -3; // Already recording, or the file cannot be created
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineStartRecording: " << e.what() << std::endl;
         return -4; // Exception occurred
     } catch (...) {
-        std::cerr << "Unknown exception in LoadGranularBuffer" << std::endl;
+        std::cerr << "Unknown exception in EngineStartRecording" << std::endl;
         return -5; // Unknown exception
     }
 }
 
+int EngineStopRecording(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return -1; // Engine not initialized
+        }
+        
+        engine->stopRecording();
+        return 0; // Success
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineStopRecording: " << e.what() << std::endl;
+        return -2; // Exception occurred
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineStopRecording" << std::endl;
+        return -3; // Unknown exception
+    }
+}
+
+long long EngineGetRecordedFrames(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return 0; // Engine not initialized
+        }
+        return static_cast<long long>(engine->getRecordedFrames());
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineGetRecordedFrames: " << e.what() << std::endl;
+        return 0;
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineGetRecordedFrames" << std::endl;
+        return 0;
+    }
+}
+
+long long EngineGetDroppedRecordingFrames(SynthEngineHandle handle) {
+    try {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
+            return 0; // Engine not initialized
+        }
+        return static_cast<long long>(engine->getDroppedRecordingFrames());
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in EngineGetDroppedRecordingFrames: " << e.what() << std::endl;
+        return 0;
+    } catch (...) {
+        std::cerr << "Unknown exception in EngineGetDroppedRecordingFrames" << std::endl;
+        return 0;
+    }
+}
+
 // Audio analysis functions for visualization
-double GetBassLevel() {
+double EngineGetBassLevel(SynthEngineHandle handle) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return 0.0; // Engine not initialized
         }
-        return engine.getBassLevel();
+        return engine->getBassLevel();
     } catch (const std::exception& e) {
-        std::cerr << "Exception in GetBassLevel: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineGetBassLevel: " << e.what() << std::endl;
         return 0.0;
     } catch (...) {
-        std::cerr << "Unknown exception in GetBassLevel" << std::endl;
+        std::cerr << "Unknown exception in EngineGetBassLevel" << std::endl;
         return 0.0;
     }
 }
 
-double GetMidLevel() {
+double EngineGetMidLevel(SynthEngineHandle handle) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return 0.0; // Engine not initialized
         }
-        return engine.getMidLevel();
+        return engine->getMidLevel();
     } catch (const std::exception& e) {
-        std::cerr << "Exception in GetMidLevel: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineGetMidLevel: " << e.what() << std::endl;
         return 0.0;
     } catch (...) {
-        std::cerr << "Unknown exception in GetMidLevel" << std::endl;
+        std::cerr << "Unknown exception in EngineGetMidLevel" << std::endl;
         return 0.0;
     }
 }
 
-double GetHighLevel() {
+double EngineGetHighLevel(SynthEngineHandle handle) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return 0.0; // Engine not initialized
         }
-        return engine.getHighLevel();
+        return engine->getHighLevel();
     } catch (const std::exception& e) {
-        std::cerr << "Exception in GetHighLevel: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineGetHighLevel: " << e.what() << std::endl;
         return 0.0;
     } catch (...) {
-        std::cerr << "Unknown exception in GetHighLevel" << std::endl;
+        std::cerr << "Unknown exception in EngineGetHighLevel" << std::endl;
         return 0.0;
     }
 }
 
-double GetAmplitudeLevel() {
+double EngineGetAmplitudeLevel(SynthEngineHandle handle) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return 0.0; // Engine not initialized
         }
-        return engine.getAmplitudeLevel();
+        return engine->getAmplitudeLevel();
     } catch (const std::exception& e) {
-        std::cerr << "Exception in GetAmplitudeLevel: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineGetAmplitudeLevel: " << e.what() << std::endl;
         return 0.0;
     } catch (...) {
-        std::cerr << "Unknown exception in GetAmplitudeLevel" << std::endl;
+        std::cerr << "Unknown exception in EngineGetAmplitudeLevel" << std::endl;
         return 0.0;
     }
 }
 
-double GetDominantFrequency() {
+double EngineGetDominantFrequency(SynthEngineHandle handle) {
     try {
-        SynthEngine& engine = SynthEngine::getInstance();
-        if (!engine.isInitialized()) {
+        SynthEngine* engine = fromHandle(handle);
+        if (!engine || !engine->isInitialized()) {
             return 0.0; // Engine not initialized
         }
-        return engine.getDominantFrequency();
+        return engine->getDominantFrequency();
     } catch (const std::exception& e) {
-        std::cerr << "Exception in GetDominantFrequency: " << e.what() << std::endl;
+        std::cerr << "Exception in EngineGetDominantFrequency: " << e.what() << std::endl;
         return 0.0;
     } catch (...) {
-        std::cerr << "Unknown exception in GetDominantFrequency" << std::endl;
+        std::cerr << "Unknown exception in EngineGetDominantFrequency" << std::endl;
         return 0.0;
     }
-}
\ No newline at end of file
+}
+
+// Singleton entry points; each forwards to the shared engine instance
+int ProcessMidiEvent(unsigned char status, unsigned char data1, unsigned char data2) {
+    return EngineProcessMidiEvent(defaultHandle(), status, data1, data2);
+}
+
+int SetParameter(int parameterId, float value) {
+    return EngineSetParameter(defaultHandle(), parameterId, value);
+}
+
+float GetParameter(int parameterId) {
+    return EngineGetParameter(defaultHandle(), parameterId);
+}
+
+int NoteOn(int note, int velocity) {
+    return EngineNoteOn(defaultHandle(), note, velocity);
+}
+
+int NoteOff(int note) {
+    return EngineNoteOff(defaultHandle(), note);
+}
+
+int LoadGranularBuffer(const float* buffer, int length) {
+    return EngineLoadGranularBuffer(defaultHandle(), buffer, length);
+}
+
+int SetRandomSeed(unsigned int seed) {
+    return EngineSetRandomSeed(defaultHandle(), seed);
+}
+
+int ScheduleNoteOn(int note, int velocity, long long sampleTime) {
+    return EngineScheduleNoteOn(defaultHandle(), note, velocity, sampleTime);
+}
+
+int ScheduleNoteOff(int note, long long sampleTime) {
+    return EngineScheduleNoteOff(defaultHandle(), note, sampleTime);
+}
+
+int ScheduleParameter(int parameterId, float value, long long sampleTime) {
+    return EngineScheduleParameter(defaultHandle(), parameterId, value, sampleTime);
+}
+
+long long GetSampleTime() {
+    return EngineGetSampleTime(defaultHandle());
+}
+
+int GetActiveVoiceCount() {
+    return EngineGetActiveVoiceCount(defaultHandle());
+}
+
+long long GetVoiceStealCount() {
+    return EngineGetVoiceStealCount(defaultHandle());
+}
+
+long long GetVoiceDropCount() {
+    return EngineGetVoiceDropCount(defaultHandle());
+}
+
+double GetDspLoad() {
+    return EngineGetDspLoad(defaultHandle());
+}
+
+int GetCallbackStats(SynthCallbackStats* stats) {
+    return EngineGetCallbackStats(defaultHandle(), stats);
+}
+
+int ResetCallbackStats() {
+    return EngineResetCallbackStats(defaultHandle());
+}
+
+int SetRenderThreadCount(int threads) {
+    return EngineSetRenderThreadCount(defaultHandle(), threads);
+}
+
+int GetRenderThreadCount() {
+    return EngineGetRenderThreadCount(defaultHandle());
+}
+
+int StartRecording(const char* path) {
+    return EngineStartRecording(defaultHandle(), path);
+}
+
+int StopRecording() {
+    return EngineStopRecording(defaultHandle());
+}
+
+long long GetRecordedFrames() {
+    return EngineGetRecordedFrames(defaultHandle());
+}
+
+long long GetDroppedRecordingFrames() {
+    return EngineGetDroppedRecordingFrames(defaultHandle());
+}
+
+// The checker is process-wide, so these have no per-engine versions
+long long GetRtSafetyViolationCount() {
+    return rtsafety::getViolationCount();
+}
+
+void ResetRtSafetyViolations() {
+    rtsafety::resetViolations();
+}
+
+void PrintRtSafetyReport() {
+    rtsafety::printReport(stdout);
+}
+
+int EngineGetProfileThreadCount(SynthEngineHandle handle) {
+    if (!Profiler::isEnabled()) {
+        return -1; // Not built in
+    }
+    SynthEngine* engine = fromHandle(handle);
+    return engine ? engine->getProfiler().getThreadCount() : 0;
+}
+
+int EngineGetProfileSnapshot(SynthEngineHandle handle, int thread, long long* nanoseconds, long long* calls, int numStages) {
+    static_assert(Profiler::kNumStages == SYNTH_PROFILE_STAGE_COUNT, "profiler stage count mismatch");
+    if (!Profiler::isEnabled()) {
+        return -1; // Not built in
+    }
+    
+    SynthEngine* engine = fromHandle(handle);
+    Profiler::Snapshot snapshot;
+    if (!engine || !engine->getProfiler().getSnapshot(thread, snapshot)) {
+        return -2; // Invalid thread slot
+    }
+    const int count = std::max(0, std::min(numStages, Profiler::kNumStages));
+    for (int stage = 0; stage < count; ++stage) {
+        if (nanoseconds) {
+            nanoseconds[stage] = static_cast<long long>(snapshot.nanoseconds[stage]);
+        }
+        if (calls) {
+            calls[stage] = static_cast<long long>(snapshot.calls[stage]);
+        }
+    }
+    return count;
+}
+
+void EngineResetProfile(SynthEngineHandle handle) {
+    SynthEngine* engine = fromHandle(handle);
+    if (engine) {
+        engine->getProfiler().reset();
+    }
+}
+
+int GetProfileThreadCount() {
+    return EngineGetProfileThreadCount(defaultHandle());
+}
+
+int GetProfileSnapshot(int thread, long long* nanoseconds, long long* calls, int numStages) {
+    return EngineGetProfileSnapshot(defaultHandle(), thread, nanoseconds, calls, numStages);
+}
+
+const char* GetProfileStageName(int stage) {
+    return Profiler::getStageName(stage);
+}
+
+void ResetProfile() {
+    EngineResetProfile(defaultHandle());
+}
+
+double GetBassLevel() {
+    return EngineGetBassLevel(defaultHandle());
+}
+
+double GetMidLevel() {
+    return EngineGetMidLevel(defaultHandle());
+}
+
+double GetHighLevel() {
+    return EngineGetHighLevel(defaultHandle());
+}
+
+double GetAmplitudeLevel() {
+    return EngineGetAmplitudeLevel(defaultHandle());
+}
+
+double GetDominantFrequency() {
+    return EngineGetDominantFrequency(defaultHandle());
+}
@@ -12,6 +12,33 @@ extern "C" {
 #define EXPORT __attribute__((visibility("default"))) __attribute__((used))
 #endif
 
+/**
+ * Opaque handle to an engine instance.
+ */
+typedef struct SynthEngineInstance* SynthEngineHandle;
+
+/**
+ * Audio callback timing, filled in by GetCallbackStats.
+ * 
+ * Load is the time spent in a callback divided by the duration of the
+ * audio it produced; at 1.0 or more the callback overruns and a device
+ * glitches. Histogram bin i counts callbacks with a load in
+ * [i * 0.1, (i + 1) * 0.1); the last bin also takes everything above.
+ */
+#ifndef SYNTH_CALLBACK_STATS_DEFINED
+#define SYNTH_CALLBACK_STATS_DEFINED
+#define SYNTH_LOAD_HISTOGRAM_BINS 20
+typedef struct SynthCallbackStats {
+    long long callbacks;
+    long long overruns;
+    double averageLoad;
+    double peakLoad;
+    double averageCallbackUs;
+    double maxCallbackUs;
+    long long histogram[SYNTH_LOAD_HISTOGRAM_BINS];
+} SynthCallbackStats;
+#endif
+
 /**
  * Initialize the synth engine.
  * 
@@ -27,6 +54,100 @@ EXPORT int InitializeSynthEngine(int sampleRate, int bufferSize, float initialVo
  */
 EXPORT void ShutdownSynthEngine();
 
+/**
+ * Create and initialize an independent engine instance.
+ * 
+ * Instances share no state with each other or with the engine behind the
+ * singleton functions, so any number can run side by side, e.g. one per
+ * worker thread.
+ * 
+ * @param sampleRate The sample rate to use (e.g., 44100, 48000)
+ * @param bufferSize The buffer size to use
+ * @param initialVolume The initial master volume (0.0 - 1.0)
+ * @return The engine handle, or null on failure
+ */
+EXPORT SynthEngineHandle CreateSynthEngine(int sampleRate, int bufferSize, float initialVolume);
+
+/**
+ * Shut down an engine instance and free it. The handle is invalid afterwards.
+ * 
+ * @param engine A handle from CreateSynthEngine; null is ignored
+ */
+EXPORT void DestroySynthEngine(SynthEngineHandle engine);
+
+/**
+ * Create a headless engine instance for offline rendering.
+ * 
+ * No audio device is opened; audio is produced only by RenderFrames, as
+ * fast as the CPU allows. Destroy it with DestroySynthEngine.
+ * 
+ * @param sampleRate The sample rate to render at
+ * @param initialVolume The initial master volume (0.0 - 1.0)
+ * @return The engine handle, or null on failure
+ */
+EXPORT SynthEngineHandle CreateOfflineSynthEngine(int sampleRate, float initialVolume);
+
+/**
+ * Render audio from a headless engine.
+ * 
+ * Notes and parameters set before the call apply at its first frame;
+ * scheduled events apply at their exact frames, which may fall in the
+ * middle of the call.
+ * 
+ * @param engine A handle from CreateOfflineSynthEngine
+ * @param out Receives frames interleaved stereo frames (frames * 2 floats)
+ * @param frames The number of frames to render
+ * @return 0 on success, non-zero error code on failure
+ */
+EXPORT int RenderFrames(SynthEngineHandle engine, float* out, int frames);
+
+/**
+ * Get a handle to the shared engine used by the singleton functions.
+ * 
+ * The handle stays valid for the life of the process; DestroySynthEngine
+ * ignores it.
+ * 
+ * @return The shared engine handle
+ */
+EXPORT SynthEngineHandle GetDefaultSynthEngine();
+
+/**
+ * Per-instance versions of the functions below.
+ * 
+ * Each takes the engine handle first and otherwise behaves like the
+ * function of the same name without the Engine prefix, with the same
+ * return codes; a null handle is treated as an uninitialized engine.
+ * Calls on different instances may run concurrently.
+ */
+EXPORT int EngineProcessMidiEvent(SynthEngineHandle engine, unsigned char status, unsigned char data1, unsigned char data2);
+EXPORT int EngineSetParameter(SynthEngineHandle engine, int parameterId, float value);
+EXPORT float EngineGetParameter(SynthEngineHandle engine, int parameterId);
+EXPORT int EngineNoteOn(SynthEngineHandle engine, int note, int velocity);
+EXPORT int EngineNoteOff(SynthEngineHandle engine, int note);
+EXPORT int EngineLoadGranularBuffer(SynthEngineHandle engine, const float* buffer, int length);
+EXPORT int EngineSetRandomSeed(SynthEngineHandle engine, unsigned int seed);
+EXPORT int EngineScheduleNoteOn(SynthEngineHandle engine, int note, int velocity, long long sampleTime);
+EXPORT int EngineScheduleNoteOff(SynthEngineHandle engine, int note, long long sampleTime);
+EXPORT int EngineScheduleParameter(SynthEngineHandle engine, int parameterId, float value, long long sampleTime);
+EXPORT long long EngineGetSampleTime(SynthEngineHandle engine);
+EXPORT int EngineGetActiveVoiceCount(SynthEngineHandle engine);
+EXPORT long long EngineGetVoiceStealCount(SynthEngineHandle engine);
+EXPORT long long EngineGetVoiceDropCount(SynthEngineHandle engine);
+EXPORT double EngineGetDspLoad(SynthEngineHandle engine);
+EXPORT int EngineGetCallbackStats(SynthEngineHandle engine, SynthCallbackStats* stats);
+EXPORT int EngineResetCallbackStats(SynthEngineHandle engine);
+EXPORT int EngineSetRenderThreadCount(SynthEngineHandle engine, int threads);
+EXPORT int EngineGetRenderThreadCount(SynthEngineHandle engine);
+EXPORT int EngineStartRecording(SynthEngineHandle engine, const char* path);
+EXPORT int EngineStopRecording(SynthEngineHandle engine);
+EXPORT long long EngineGetRecordedFrames(SynthEngineHandle engine);
+EXPORT long long EngineGetDroppedRecordingFrames(SynthEngineHandle engine);
+EXPORT double EngineGetBassLevel(SynthEngineHandle engine);
+EXPORT double EngineGetMidLevel(SynthEngineHandle engine);
+EXPORT double EngineGetHighLevel(SynthEngineHandle engine);
+EXPORT double EngineGetAmplitudeLevel(SynthEngineHandle engine);
+EXPORT double EngineGetDominantFrequency(SynthEngineHandle engine);
+
 /**
  * Process a MIDI event.
  * 
@@ -80,6 +201,145 @@ EXPORT int NoteOff(int note);
  */
 EXPORT int LoadGranularBuffer(const float* buffer, int length);
 
+/**
+ * Reseed the noise waveform and the granular variations at the start of
+ * the next audio block. The same seed and events render the same audio
+ * every time, with any number of render threads.
+ * 
+ * @param seed The seed
+ * @return 0 on success, non-zero error code on failure
+ */
+EXPORT int SetRandomSeed(unsigned int seed);
+
+/**
+ * Schedule events at an exact frame of the engine sample clock.
+ * 
+ * Events are applied by the audio thread, which splits its block at each
+ * event's frame. Times already in the past apply at the start of the next
+ * block. At most 1024 events can be pending at once. Each returns 0 on
+ * success, -1 if the engine is not initialized, -2 for a negative sample
+ * time, -3 if the event queue is full, -4 or -5 on an exception, and -6
+ * for an invalid argument: a note or velocity outside 0-127, an unknown
+ * parameter ID or a NaN value.
+ * 
+ * @param sampleTime The engine sample time, see GetSampleTime()
+ */
+EXPORT int ScheduleNoteOn(int note, int velocity, long long sampleTime);
+EXPORT int ScheduleNoteOff(int note, long long sampleTime);
+EXPORT int ScheduleParameter(int parameterId, float value, long long sampleTime);
+
+/**
+ * Get the engine sample clock: frames rendered since initialization.
+ * 
+ * @return The sample time of the first frame of the next audio block
+ */
+EXPORT long long GetSampleTime();
+
+/**
+ * Voice allocation statistics.
+ * 
+ * GetActiveVoiceCount returns the voices sounding at the end of the last
+ * audio block. GetVoiceStealCount and GetVoiceDropCount return the number
+ * of notes that stole a busy voice, and the number of notes dropped
+ * because the steal policy forbids stealing.
+ */
+EXPORT int GetActiveVoiceCount();
+EXPORT long long GetVoiceStealCount();
+EXPORT long long GetVoiceDropCount();
+
+/**
+ * DSP load of the audio callback.
+ * 
+ * GetDspLoad returns the share of the buffer period the last few callbacks
+ * used, smoothed; 1.0 or more means the engine cannot keep up.
+ * GetCallbackStats fills in the totals and load histogram since the engine
+ * started or the last ResetCallbackStats, and returns 0 on success.
+ */
+EXPORT double GetDspLoad();
+EXPORT int GetCallbackStats(SynthCallbackStats* stats);
+EXPORT int ResetCallbackStats();
+
+/**
+ * Set how many threads render voices, including the audio thread.
+ * 
+ * @param threads 1 renders on the audio thread only, 0 uses one thread
+ *                per CPU core, up to 8
+ * @return 0 on success, non-zero error code on failure
+ */
+EXPORT int SetRenderThreadCount(int threads);
+
+/**
+ * Get the number of threads rendering voices.
+ * 
+ * @return The thread count including the audio thread
+ */
+EXPORT int GetRenderThreadCount();
+
+/**
+ * Start recording the master output to a 32-bit float WAV file.
+ * 
+ * The file is written by a background thread and becomes RF64 beyond
+ * 4 GB; the audio callback never waits for the disk.
+ * 
+ * @param path The output file path; an existing file is overwritten
+ * @return 0 on success, non-zero error code on failure
+ */
+EXPORT int StartRecording(const char* path);
+
+/**
+ * Stop recording and finalize the file.
+ * 
+ * @return 0 on success, non-zero error code on failure
+ */
+EXPORT int StopRecording();
+
+/**
+ * Recording statistics since the last StartRecording.
+ * 
+ * GetRecordedFrames returns the frames written to the file so far.
+ * GetDroppedRecordingFrames returns the frames lost because the writer
+ * could not keep up with the audio thread.
+ */
+EXPORT long long GetRecordedFrames();
+EXPORT long long GetDroppedRecordingFrames();
+
+/**
+ * Real-time safety checker, for debug builds configured with
+ * SYNTH_RT_SAFETY_CHECKS.
+ * 
+ * GetRtSafetyViolationCount returns the allocations, frees and mutex locks
+ * seen on any engine's audio thread, or -1 if the checker is not built in.
+ * PrintRtSafetyReport prints the count and each offending stage and caller
+ * to stdout; call it from a control thread.
+ */
+EXPORT long long GetRtSafetyViolationCount();
+EXPORT void ResetRtSafetyViolations();
+EXPORT void PrintRtSafetyReport();
+
+/**
+ * Render stage profiler, for builds configured with SYNTH_ENABLE_PROFILING.
+ * 
+ * Each engine keeps its own time and call count per stage for every
+ * thread that renders it: slot 0 is the audio thread (or the caller of
+ * RenderFrames) and the voice workers follow. The Engine* functions read
+ * one engine; the others read the default engine. GetProfileThreadCount
+ * returns the number of slots in use, or -1 if the profiler is not built in.
+ * 
+ * @param thread The thread slot, or -1 for the sum over all threads
+ * @param nanoseconds Receives the total time per stage; may be null
+ * @param calls Receives the number of timed scopes per stage; may be null
+ * @param numStages The length of the arrays
+ * @return The number of stages written, -1 if the profiler is not built
+ *         in, -2 if the thread slot is invalid
+ */
+EXPORT int EngineGetProfileThreadCount(SynthEngineHandle engine);
+EXPORT int EngineGetProfileSnapshot(SynthEngineHandle engine, int thread, long long* nanoseconds, long long* calls, int numStages);
+EXPORT void EngineResetProfile(SynthEngineHandle engine);
+EXPORT int GetProfileThreadCount();
+EXPORT int GetProfileSnapshot(int thread, long long* nanoseconds, long long* calls, int numStages);
+EXPORT const char* GetProfileStageName(int stage);
+EXPORT void ResetProfile();
+
 /**
  * Audio analysis functions for visualization.
  */
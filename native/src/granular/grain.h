@@ -66,6 +66,19 @@ public:
         return sample;
     }
     
+    // Add a block of the grain to a stereo buffer, panned by the grain's pan
+    void processBlock(const std::vector<float>& buffer, float sampleRate,
+                      float* left, float* right, int numSamples) {
+        const float leftGain = std::sqrt(0.5f * (1.0f - pan_));
+        const float rightGain = std::sqrt(0.5f * (1.0f + pan_));
+        
+        for (int i = 0; i < numSamples && isActive_; ++i) {
+            float grainSample = process(buffer, sampleRate);
+            left[i] += grainSample * leftGain;
+            right[i] += grainSample * rightGain;
+        }
+    }
+    
     bool isActive() const { return isActive_; }
     float getPan() const { return pan_; }
     
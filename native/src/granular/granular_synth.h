@@ -3,6 +3,7 @@
 #include <vector>
 #include <random>
 #include <algorithm>
+#include <cstdint>
 
 namespace synth {
 
@@ -38,6 +39,15 @@ public:
         sourceBuffer_ = buffer;
     }
     
+    /**
+     * Exchange the source buffer with another one without copying or
+     * allocating, so a buffer prepared elsewhere can be swapped in on the
+     * audio thread.
+     */
+    void swapBuffer(std::vector<float>& buffer) {
+        sourceBuffer_.swap(buffer);
+    }
+    
     void clearBuffer() {
         sourceBuffer_.clear();
     }
@@ -77,6 +87,44 @@ public:
         right *= amplitude_;
     }
     
+    // Process a block of stereo output; same result as calling process()
+    // per frame, with the block split at each grain trigger
+    void processBlock(float* left, float* right, int numSamples) {
+        std::fill(left, left + numSamples, 0.0f);
+        std::fill(right, right + numSamples, 0.0f);
+        
+        if (sourceBuffer_.empty()) return;
+        
+        const float framesBetweenGrains = sampleRate_ / grainRate_;
+        int start = 0;
+        while (start < numSamples) {
+            if (framesSinceLastGrain_ >= framesBetweenGrains) {
+                triggerNewGrain();
+                framesSinceLastGrain_ = 0;
+            }
+            
+            // Run up to the frame where the next grain is due
+            float remaining = framesBetweenGrains - static_cast<float>(framesSinceLastGrain_);
+            int segment = remaining > 1.0f ? static_cast<int>(std::ceil(remaining)) : 1;
+            segment = std::min(segment, numSamples - start);
+            
+            for (auto& grain : grains_) {
+                if (grain.isActive()) {
+                    grain.processBlock(sourceBuffer_, sampleRate_, left + start, right + start, segment);
+                }
+            }
+            
+            framesSinceLastGrain_ += segment;
+            start += segment;
+        }
+        
+        // Apply master amplitude
+        for (int i = 0; i < numSamples; ++i) {
+            left[i] *= amplitude_;
+            right[i] *= amplitude_;
+        }
+    }
+    
     // Granular parameters
     void setGrainRate(float rate) { grainRate_ = std::max(0.1f, std::min(100.0f, rate)); }
     void setGrainDuration(float duration) { grainDuration_ = std::max(0.001f, std::min(1.0f, duration)); }
@@ -90,12 +138,25 @@ public:
     void setPanVariation(float variation) { panVariation_ = std::max(0.0f, std::min(1.0f, variation)); }
     void setWindowType(Grain::WindowType type) { windowType_ = type; }
     
+    // Restart the generator behind the variations; a given seed and
+    // parameter history always produce the same grains
+    void setSeed(uint32_t seed) {
+        randomEngine_.seed(seed);
+        randomDist_.reset();
+    }
+    
     // Getters
     float getGrainRate() const { return grainRate_; }
     float getGrainDuration() const { return grainDuration_; }
     float getPosition() const { return position_; }
     float getPitch() const { return pitch_; }
     float getAmplitude() const { return amplitude_; }
+    float getGrainDurationVariation() const { return grainDurationVariation_; }
+    float getPositionVariation() const { return positionVariation_; }
+    float getPitchVariation() const { return pitchVariation_; }
+    float getPan() const { return pan_; }
+    float getPanVariation() const { return panVariation_; }
+    Grain::WindowType getWindowType() const { return windowType_; }
     
 private:
     void triggerNewGrain() {
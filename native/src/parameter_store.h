@@ -0,0 +1,128 @@
+#ifndef PARAMETER_STORE_H
+#define PARAMETER_STORE_H
+
+#include <atomic>
+
+/**
+ * Dense, lock-free parameter storage indexed by parameter ID.
+ *
+ * Each parameter has two shared slots:
+ * - requested: the last value a control thread asked for. Setting it is a
+ *   single relaxed store, cheap enough for continuous controller streams.
+ * - applied: the value the DSP is actually using after clamping, written
+ *   by the audio thread and read by getParameter.
+ *
+ * Once per block the audio thread compares every requested value with the
+ * last one it acted on and applies the ones that changed, so a burst of
+ * updates between two blocks costs one apply per parameter.
+ */
+class ParameterStore {
+public:
+    static constexpr int kNumParameters = 256;
+
+    static bool isValid(int id) {
+        return id >= 0 && id < kNumParameters;
+    }
+
+    /**
+     * Set all slots of a parameter at once. Only valid while the audio
+     * thread is not running, e.g. during initialization.
+     *
+     * @param id The parameter ID
+     * @param value The current value of the parameter
+     */
+    void reset(int id, float value) {
+        requested[id].store(value, std::memory_order_relaxed);
+        applied[id].store(value, std::memory_order_relaxed);
+        seen[id] = value;
+    }
+
+    /**
+     * Mark whether an ID names a parameter the engine handles. Only valid
+     * while the audio thread is not running, e.g. during initialization.
+     *
+     * @param id The parameter ID
+     * @param isKnown True if the engine applies this parameter
+     */
+    void setKnown(int id, bool isKnown) {
+        known[id] = isKnown;
+    }
+
+    /**
+     * Check that an ID is valid and names a handled parameter, so that
+     * typos can be rejected. Any thread.
+     *
+     * @param id The parameter ID
+     * @return True if the engine applies this parameter
+     */
+    bool isKnownId(int id) const {
+        return isValid(id) && known[id];
+    }
+
+    /**
+     * Request a new value. Control threads; a single store.
+     *
+     * @param id A valid parameter ID
+     * @param value The new value
+     */
+    void request(int id, float value) {
+        requested[id].store(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * Get the value the DSP is using. Any thread; a single load.
+     *
+     * @param id A valid parameter ID
+     * @return The applied value
+     */
+    float get(int id) const {
+        return applied[id].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Record the value the DSP now uses. Audio thread only.
+     */
+    void setApplied(int id, float value) {
+        applied[id].store(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * Call apply(id, value) for every parameter requested since the last
+     * call. Audio thread only.
+     */
+    template <typename ApplyFn>
+    void applyRequested(ApplyFn&& apply) {
+        for (int id = 0; id < kNumParameters; ++id) {
+            const float value = requested[id].load(std::memory_order_relaxed);
+            if (value != seen[id]) {
+                seen[id] = value;
+                apply(id, value);
+            }
+        }
+    }
+
+    /**
+     * Note that the audio thread applied a value that did not come through
+     * request(), e.g. a scheduled event, so that a later request for the
+     * old value is still seen as a change. If a control thread requested
+     * something in the meantime, that newer request is kept and applied
+     * at the next applyRequested(). Audio thread only.
+     *
+     * @param id A valid parameter ID
+     * @param value The value that was applied
+     */
+    void overrideRequested(int id, float value) {
+        float expected = seen[id];
+        if (requested[id].compare_exchange_strong(expected, value, std::memory_order_relaxed)) {
+            seen[id] = value;
+        }
+    }
+
+private:
+    alignas(64) std::atomic<float> requested[kNumParameters] = {};
+    alignas(64) std::atomic<float> applied[kNumParameters] = {};
+    alignas(64) float seen[kNumParameters] = {}; // Audio thread only
+    bool known[kNumParameters] = {};              // Written during initialization only
+};
+
+#endif // PARAMETER_STORE_H
@@ -0,0 +1,119 @@
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+const char* const kStageNames[Profiler::kNumStages] = {
+    "control",
+    "modulation",
+    "oscillators",
+    "envelope",
+    "filter",
+    "granular",
+    "delay",
+    "reverb",
+    "output",
+    "analysis"
+};
+
+#ifdef SYNTH_PROFILING
+
+// The slot the calling thread records into; a plain pointer, so the
+// thread_local needs no constructor on the audio thread
+thread_local void* threadSlot = nullptr;
+
+#endif // SYNTH_PROFILING
+
+} // namespace
+
+const char* Profiler::getStageName(int stage) {
+    return stage >= 0 && stage < kNumStages ? kStageNames[stage] : nullptr;
+}
+
+#ifdef SYNTH_PROFILING
+
+Profiler::ThreadScope::ThreadScope(Profiler& profiler, int thread)
+    : previous(static_cast<ThreadCounters*>(threadSlot)) {
+    thread = std::clamp(thread, 0, kMaxThreads - 1);
+    threadSlot = &profiler.slots[thread];
+    
+    // Slots are entered in order as the worker pool grows
+    int count = profiler.slotCount.load(std::memory_order_relaxed);
+    while (count <= thread &&
+           !profiler.slotCount.compare_exchange_weak(count, thread + 1, std::memory_order_relaxed)) {
+    }
+}
+
+Profiler::ThreadScope::~ThreadScope() {
+    threadSlot = previous;
+}
+
+bool Profiler::isEnabled() {
+    return true;
+}
+
+void Profiler::record(ProfileStage stage, uint64_t nanoseconds) {
+    ThreadCounters* counters = static_cast<ThreadCounters*>(threadSlot);
+    if (!counters) {
+        return; // Not inside a render thread scope
+    }
+    const int s = static_cast<int>(stage);
+    counters->nanoseconds[s].fetch_add(nanoseconds, std::memory_order_relaxed);
+    counters->calls[s].fetch_add(1, std::memory_order_relaxed);
+}
+
+int Profiler::getThreadCount() const {
+    return slotCount.load(std::memory_order_relaxed);
+}
+
+bool Profiler::getSnapshot(int thread, Snapshot& snapshot) const {
+    const int count = getThreadCount();
+    if (thread < -1 || thread >= count) {
+        return false;
+    }
+
+    snapshot = Snapshot();
+    const int first = thread < 0 ? 0 : thread;
+    const int last = thread < 0 ? count : thread + 1;
+    for (int t = first; t < last; ++t) {
+        for (int s = 0; s < kNumStages; ++s) {
+            snapshot.nanoseconds[s] += slots[t].nanoseconds[s].load(std::memory_order_relaxed);
+            snapshot.calls[s] += slots[t].calls[s].load(std::memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+void Profiler::reset() {
+    for (ThreadCounters& counters : slots) {
+        for (int s = 0; s < kNumStages; ++s) {
+            counters.nanoseconds[s].store(0, std::memory_order_relaxed);
+            counters.calls[s].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+#else // SYNTH_PROFILING
+
+bool Profiler::isEnabled() {
+    return false;
+}
+
+Profiler::ThreadScope::ThreadScope(Profiler&, int) : previous(nullptr) {}
+
+Profiler::ThreadScope::~ThreadScope() {}
+
+void Profiler::record(ProfileStage, uint64_t) {}
+
+int Profiler::getThreadCount() const {
+    return 0;
+}
+
+bool Profiler::getSnapshot(int, Snapshot&) const {
+    return false;
+}
+
+void Profiler::reset() {}
+
+#endif // SYNTH_PROFILING
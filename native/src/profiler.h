@@ -0,0 +1,161 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Stages of the render loop that the profiler times separately.
+ */
+enum class ProfileStage : int {
+    Control,     // Parameter changes, commands and scheduled events
+    Modulation,  // Parameter smoothing and the modulation matrix
+    Oscillators,
+    Envelope,
+    Filter,
+    Granular,
+    Delay,
+    Reverb,
+    Output,      // Master volume, recorder
+    Analysis,
+    Count
+};
+
+/**
+ * Per-stage time spent in one engine's render loop, per render thread.
+ *
+ * Built with SYNTH_PROFILING (CMake option SYNTH_ENABLE_PROFILING), each
+ * engine owns a Profiler with one block of counters per render thread:
+ * slot 0 for the thread that calls processAudio() and one for each voice
+ * worker. A render thread enters its slot with SYNTH_PROFILE_THREAD, and
+ * every SYNTH_PROFILE scope on that thread adds its steady_clock duration
+ * there, so threads never share a cache line and engines never mix. The
+ * slots belong to the engine, not to OS threads, so rebuilding the worker
+ * pool reuses them. Any thread can read the counters at any time. Without
+ * the flag the scopes compile to nothing.
+ */
+class Profiler {
+    struct ThreadCounters;
+
+public:
+    static constexpr int kNumStages = static_cast<int>(ProfileStage::Count);
+    static constexpr int kMaxThreads = 8;
+
+    /**
+     * Totals for one thread, or summed over all threads.
+     */
+    struct Snapshot {
+        std::array<uint64_t, kNumStages> nanoseconds{};
+        std::array<uint64_t, kNumStages> calls{};
+    };
+
+    /**
+     * Direct the calling thread's scopes to one slot of a profiler until
+     * destroyed; scopes nest and restore the previous slot.
+     */
+    class ThreadScope {
+    public:
+        /**
+         * @param profiler The engine's profiler
+         * @param thread The render thread index, 0 - kMaxThreads - 1
+         */
+        ThreadScope(Profiler& profiler, int thread);
+        ~ThreadScope();
+
+        ThreadScope(const ThreadScope&) = delete;
+        ThreadScope& operator=(const ThreadScope&) = delete;
+
+    private:
+        ThreadCounters* const previous;
+    };
+
+    /**
+     * Whether the profiler is compiled in.
+     */
+    static bool isEnabled();
+
+    /**
+     * Add one timed scope to the slot the calling thread entered with a
+     * ThreadScope. Lock-free; does nothing outside one.
+     *
+     * @param stage The stage
+     * @param nanoseconds The time spent in it
+     */
+    static void record(ProfileStage stage, uint64_t nanoseconds);
+
+    /**
+     * The number of thread slots that have recorded anything.
+     */
+    int getThreadCount() const;
+
+    /**
+     * Read the counters. Safe to call from any thread while rendering.
+     *
+     * @param thread A slot index below getThreadCount(), or -1 for the
+     *               sum over all threads
+     * @param snapshot Receives the totals
+     * @return True on success, false if the slot is not in use
+     */
+    bool getSnapshot(int thread, Snapshot& snapshot) const;
+
+    /**
+     * Zero every counter; the slots stay in use.
+     */
+    void reset();
+
+    /**
+     * Get the display name of a stage.
+     *
+     * @param stage The stage index, 0 - kNumStages - 1
+     * @return The name, or null if out of range
+     */
+    static const char* getStageName(int stage);
+
+private:
+    // One cache-line aligned block of counters per render thread
+    struct alignas(64) ThreadCounters {
+        std::atomic<uint64_t> nanoseconds[kNumStages] = {};
+        std::atomic<uint64_t> calls[kNumStages] = {};
+    };
+
+    ThreadCounters slots[kMaxThreads];
+    std::atomic<int> slotCount{0};
+};
+
+/**
+ * Times the enclosing scope into one stage.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileStage stage)
+        : stage(stage), start(std::chrono::steady_clock::now()) {}
+
+    ~ProfileScope() {
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        Profiler::record(stage, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const ProfileStage stage;
+    const std::chrono::steady_clock::time_point start;
+};
+
+#define SYNTH_PROFILE_CONCAT_INNER(a, b) a##b
+#define SYNTH_PROFILE_CONCAT(a, b) SYNTH_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef SYNTH_PROFILING
+#define SYNTH_PROFILE_THREAD(profiler, thread) \
+    Profiler::ThreadScope SYNTH_PROFILE_CONCAT(profileThread, __LINE__)(profiler, thread)
+#define SYNTH_PROFILE(stage) ProfileScope SYNTH_PROFILE_CONCAT(profileScope, __LINE__)(ProfileStage::stage)
+#else
+#define SYNTH_PROFILE_THREAD(profiler, thread) ((void)0)
+#define SYNTH_PROFILE(stage) ((void)0)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,415 @@
+#include "rt_safety.h"
+
+#ifdef SYNTH_RT_SAFETY_CHECKS
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(_WIN32)
+#include <intrin.h>
+#define RT_SAFETY_CALLER() _ReturnAddress()
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+#define RT_SAFETY_CALLER() __builtin_return_address(0)
+#endif
+
+#if defined(__APPLE__)
+#define RT_SAFETY_DYLD_INTERPOSE 1
+#elif defined(__linux__) || defined(__ANDROID__)
+#define RT_SAFETY_ELF_INTERPOSE 1
+#endif
+
+#if defined(__GNUC__)
+// Initial-exec TLS never allocates on first access, which matters inside malloc
+#define RT_SAFETY_TLS __attribute__((tls_model("initial-exec")))
+#define RT_SAFETY_EXPORT __attribute__((visibility("default")))
+#else
+#define RT_SAFETY_TLS
+#define RT_SAFETY_EXPORT
+#endif
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void __libc_free(void* pointer);
+}
+#endif
+
+namespace {
+
+using rtsafety::Violation;
+
+constexpr int kMaxStageDepth = 16;
+constexpr int kMaxRecords = 1024;
+
+// Plain data, so the thread_local needs no constructor
+struct ThreadState {
+    int audioDepth;
+    int stageDepth;
+    int recording; // Set while a violation is being recorded
+    const char* stages[kMaxStageDepth];
+};
+
+thread_local ThreadState threadState RT_SAFETY_TLS;
+
+struct Record {
+    std::atomic<bool> ready;
+    Violation kind;
+    const char* stage;
+    void* caller;
+};
+
+Record records[kMaxRecords];
+std::atomic<long long> violationCount{0};
+
+void pushStage(const char* tag) {
+    ThreadState& state = threadState;
+    if (state.stageDepth < kMaxStageDepth) {
+        state.stages[state.stageDepth] = tag;
+    }
+    ++state.stageDepth;
+}
+
+void popStage() {
+    --threadState.stageDepth;
+}
+
+// Called from the interposed functions; must not allocate or lock
+void recordViolation(Violation kind, void* caller) {
+    ThreadState& state = threadState;
+    if (state.audioDepth == 0 || state.recording) {
+        return;
+    }
+    state.recording = 1;
+
+    const long long index = violationCount.fetch_add(1, std::memory_order_relaxed);
+    if (index < kMaxRecords) {
+        Record& record = records[index];
+        const int depth = std::min(state.stageDepth, kMaxStageDepth);
+        record.kind = kind;
+        record.stage = depth > 0 ? state.stages[depth - 1] : "audio";
+        record.caller = caller;
+        record.ready.store(true, std::memory_order_release);
+    }
+
+    state.recording = 0;
+}
+
+const char* violationName(Violation kind) {
+    switch (kind) {
+        case Violation::Allocation:
+            return "allocation";
+        case Violation::Deallocation:
+            return "deallocation";
+        case Violation::MutexLock:
+            return "mutex lock";
+    }
+    return "unknown";
+}
+
+// The allocator underneath the interposed entry points
+#if defined(__GLIBC__)
+void* realMalloc(size_t size) { return __libc_malloc(size); }
+void* realCalloc(size_t count, size_t size) { return __libc_calloc(count, size); }
+void* realRealloc(void* pointer, size_t size) { return __libc_realloc(pointer, size); }
+void realFree(void* pointer) { __libc_free(pointer); }
+#elif defined(RT_SAFETY_ELF_INTERPOSE)
+template <typename Function>
+Function nextSymbol(std::atomic<Function>& cache, const char* name) {
+    Function function = cache.load(std::memory_order_acquire);
+    if (!function) {
+        function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+        cache.store(function, std::memory_order_release);
+    }
+    return function;
+}
+
+std::atomic<void* (*)(size_t)> nextMalloc{nullptr};
+std::atomic<void* (*)(size_t, size_t)> nextCalloc{nullptr};
+std::atomic<void* (*)(void*, size_t)> nextRealloc{nullptr};
+std::atomic<void (*)(void*)> nextFree{nullptr};
+
+void* realMalloc(size_t size) { return nextSymbol(nextMalloc, "malloc")(size); }
+void* realCalloc(size_t count, size_t size) { return nextSymbol(nextCalloc, "calloc")(count, size); }
+void* realRealloc(void* pointer, size_t size) { return nextSymbol(nextRealloc, "realloc")(pointer, size); }
+void realFree(void* pointer) { nextSymbol(nextFree, "free")(pointer); }
+#else
+// Inside the interposing image dyld leaves these calls alone; on Windows
+// only operator new and delete are covered
+void* realMalloc(size_t size) { return std::malloc(size); }
+void realFree(void* pointer) { std::free(pointer); }
+#endif
+
+#if defined(RT_SAFETY_ELF_INTERPOSE)
+std::atomic<int (*)(pthread_mutex_t*)> nextMutexLock{nullptr};
+
+int realMutexLock(pthread_mutex_t* mutex) {
+    int (*function)(pthread_mutex_t*) = nextMutexLock.load(std::memory_order_acquire);
+    if (!function) {
+        function = reinterpret_cast<int (*)(pthread_mutex_t*)>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        nextMutexLock.store(function, std::memory_order_release);
+    }
+    return function(mutex);
+}
+#endif
+
+void* checkedNew(size_t size, void* caller) {
+    recordViolation(Violation::Allocation, caller);
+    return realMalloc(size == 0 ? 1 : size);
+}
+
+void checkedDelete(void* pointer, void* caller) {
+    if (pointer) {
+        recordViolation(Violation::Deallocation, caller);
+        realFree(pointer);
+    }
+}
+
+} // namespace
+
+// Interposed C entry points. On ELF targets the engine library exports
+// them and the dynamic linker binds every caller in the process here
+#if defined(RT_SAFETY_ELF_INTERPOSE)
+extern "C" {
+
+RT_SAFETY_EXPORT void* malloc(size_t size) {
+    recordViolation(Violation::Allocation, RT_SAFETY_CALLER());
+    return realMalloc(size);
+}
+
+RT_SAFETY_EXPORT void* calloc(size_t count, size_t size) {
+    recordViolation(Violation::Allocation, RT_SAFETY_CALLER());
+    return realCalloc(count, size);
+}
+
+RT_SAFETY_EXPORT void* realloc(void* pointer, size_t size) {
+    recordViolation(Violation::Allocation, RT_SAFETY_CALLER());
+    return realRealloc(pointer, size);
+}
+
+RT_SAFETY_EXPORT void free(void* pointer) {
+    if (pointer) {
+        recordViolation(Violation::Deallocation, RT_SAFETY_CALLER());
+    }
+    realFree(pointer);
+}
+
+RT_SAFETY_EXPORT int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    recordViolation(Violation::MutexLock, RT_SAFETY_CALLER());
+    return realMutexLock(mutex);
+}
+
+} // extern "C"
+#elif defined(RT_SAFETY_DYLD_INTERPOSE)
+namespace {
+
+void* interposedMalloc(size_t size) {
+    recordViolation(Violation::Allocation, RT_SAFETY_CALLER());
+    return malloc(size);
+}
+
+void* interposedCalloc(size_t count, size_t size) {
+    recordViolation(Violation::Allocation, RT_SAFETY_CALLER());
+    return calloc(count, size);
+}
+
+void* interposedRealloc(void* pointer, size_t size) {
+    recordViolation(Violation::Allocation, RT_SAFETY_CALLER());
+    return realloc(pointer, size);
+}
+
+void interposedFree(void* pointer) {
+    if (pointer) {
+        recordViolation(Violation::Deallocation, RT_SAFETY_CALLER());
+    }
+    free(pointer);
+}
+
+int interposedMutexLock(pthread_mutex_t* mutex) {
+    recordViolation(Violation::MutexLock, RT_SAFETY_CALLER());
+    return pthread_mutex_lock(mutex);
+}
+
+struct Interposer {
+    const void* replacement;
+    const void* replacee;
+};
+
+// dyld rebinds every image except this one to the replacements
+__attribute__((used)) const Interposer kInterposers[] __attribute__((section("__DATA,__interpose"))) = {
+    {reinterpret_cast<const void*>(&interposedMalloc), reinterpret_cast<const void*>(&malloc)},
+    {reinterpret_cast<const void*>(&interposedCalloc), reinterpret_cast<const void*>(&calloc)},
+    {reinterpret_cast<const void*>(&interposedRealloc), reinterpret_cast<const void*>(&realloc)},
+    {reinterpret_cast<const void*>(&interposedFree), reinterpret_cast<const void*>(&free)},
+    {reinterpret_cast<const void*>(&interposedMutexLock), reinterpret_cast<const void*>(&pthread_mutex_lock)},
+};
+
+} // namespace
+#endif
+
+// Replaceable global allocation functions, on every platform
+RT_SAFETY_EXPORT void* operator new(std::size_t size) {
+    if (void* pointer = checkedNew(size, RT_SAFETY_CALLER())) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+RT_SAFETY_EXPORT void* operator new[](std::size_t size) {
+    if (void* pointer = checkedNew(size, RT_SAFETY_CALLER())) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+RT_SAFETY_EXPORT void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return checkedNew(size, RT_SAFETY_CALLER());
+}
+
+RT_SAFETY_EXPORT void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return checkedNew(size, RT_SAFETY_CALLER());
+}
+
+RT_SAFETY_EXPORT void operator delete(void* pointer) noexcept {
+    checkedDelete(pointer, RT_SAFETY_CALLER());
+}
+
+RT_SAFETY_EXPORT void operator delete[](void* pointer) noexcept {
+    checkedDelete(pointer, RT_SAFETY_CALLER());
+}
+
+RT_SAFETY_EXPORT void operator delete(void* pointer, std::size_t) noexcept {
+    checkedDelete(pointer, RT_SAFETY_CALLER());
+}
+
+RT_SAFETY_EXPORT void operator delete[](void* pointer, std::size_t) noexcept {
+    checkedDelete(pointer, RT_SAFETY_CALLER());
+}
+
+RT_SAFETY_EXPORT void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    checkedDelete(pointer, RT_SAFETY_CALLER());
+}
+
+RT_SAFETY_EXPORT void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    checkedDelete(pointer, RT_SAFETY_CALLER());
+}
+
+namespace rtsafety {
+
+AudioThreadScope::AudioThreadScope(const char* tag) {
+    ++threadState.audioDepth;
+    pushStage(tag);
+}
+
+AudioThreadScope::~AudioThreadScope() {
+    popStage();
+    --threadState.audioDepth;
+}
+
+StageTag::StageTag(const char* tag) {
+    pushStage(tag);
+}
+
+StageTag::~StageTag() {
+    popStage();
+}
+
+bool isEnabled() {
+    return true;
+}
+
+long long getViolationCount() {
+    return violationCount.load(std::memory_order_relaxed);
+}
+
+void resetViolations() {
+    // Records being written concurrently may survive the reset; fine for a
+    // debug counter
+    for (Record& record : records) {
+        record.ready.store(false, std::memory_order_relaxed);
+    }
+    violationCount.store(0, std::memory_order_relaxed);
+}
+
+void printReport(std::FILE* out) {
+    const long long count = getViolationCount();
+    std::fprintf(out, "RT safety: %lld violation%s on the audio thread\n", count, count == 1 ? "" : "s");
+
+    struct Entry {
+        Violation kind;
+        const char* stage;
+        void* caller;
+        long long hits;
+    };
+    std::vector<Entry> entries;
+    const int itemized = static_cast<int>(std::min<long long>(count, kMaxRecords));
+    for (int i = 0; i < itemized; ++i) {
+        const Record& record = records[i];
+        if (!record.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+        auto match = std::find_if(entries.begin(), entries.end(), [&record](const Entry& entry) {
+            return entry.kind == record.kind && entry.stage == record.stage && entry.caller == record.caller;
+        });
+        if (match != entries.end()) {
+            ++match->hits;
+        } else {
+            entries.push_back({record.kind, record.stage, record.caller, 1});
+        }
+    }
+
+    for (const Entry& entry : entries) {
+        std::fprintf(out, "  %6lld x %-12s in %-20s from %p", entry.hits, violationName(entry.kind),
+                     entry.stage, entry.caller);
+#if !defined(_WIN32)
+        // Exported symbol if there is one, otherwise the module and offset
+        Dl_info info;
+        if (dladdr(entry.caller, &info)) {
+            if (info.dli_sname) {
+                std::fprintf(out, " %s", info.dli_sname);
+            } else if (info.dli_fname) {
+                const char* slash = std::strrchr(info.dli_fname, '/');
+                std::fprintf(out, " %s+0x%zx", slash ? slash + 1 : info.dli_fname,
+                             static_cast<size_t>(static_cast<const char*>(entry.caller) -
+                                                 static_cast<const char*>(info.dli_fbase)));
+            }
+        }
+#endif
+        std::fprintf(out, "\n");
+    }
+    if (count > kMaxRecords) {
+        std::fprintf(out, "  (only the first %d are itemized)\n", kMaxRecords);
+    }
+    std::fflush(out);
+}
+
+} // namespace rtsafety
+
+#else // SYNTH_RT_SAFETY_CHECKS
+
+namespace rtsafety {
+
+bool isEnabled() {
+    return false;
+}
+
+long long getViolationCount() {
+    return -1;
+}
+
+void resetViolations() {}
+
+void printReport(std::FILE* out) {
+    std::fprintf(out, "RT safety: checker not built in (configure with -DSYNTH_RT_SAFETY_CHECKS=ON)\n");
+}
+
+} // namespace rtsafety
+
+#endif // SYNTH_RT_SAFETY_CHECKS
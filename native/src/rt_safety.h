@@ -0,0 +1,91 @@
+#ifndef RT_SAFETY_H
+#define RT_SAFETY_H
+
+#include <cstdio>
+
+/**
+ * Debug checker for real-time safety on the audio thread.
+ *
+ * Built with SYNTH_RT_SAFETY_CHECKS (CMake option of the same name), the
+ * engine interposes the allocator (malloc, free, operator new and delete)
+ * and pthread_mutex_lock. Any call made while a thread is inside an
+ * audio-thread scope is recorded with the innermost stage tag and the
+ * calling address. Nothing is printed from the audio thread; read the
+ * count over FFI, or print the report from a control thread.
+ *
+ * Without the flag the macros compile to nothing and the count reads -1.
+ */
+namespace rtsafety {
+
+enum class Violation {
+    Allocation,
+    Deallocation,
+    MutexLock
+};
+
+/**
+ * Mark the current thread as an audio thread until destroyed. Scopes nest,
+ * so a backend callback and processAudio() can both hold one.
+ */
+class AudioThreadScope {
+public:
+    explicit AudioThreadScope(const char* tag);
+    ~AudioThreadScope();
+
+    AudioThreadScope(const AudioThreadScope&) = delete;
+    AudioThreadScope& operator=(const AudioThreadScope&) = delete;
+};
+
+/**
+ * Name the processing stage that violations inside this scope belong to.
+ *
+ * @param tag A string literal; only the pointer is stored
+ */
+class StageTag {
+public:
+    explicit StageTag(const char* tag);
+    ~StageTag();
+
+    StageTag(const StageTag&) = delete;
+    StageTag& operator=(const StageTag&) = delete;
+};
+
+/**
+ * Whether the checker is compiled in.
+ */
+bool isEnabled();
+
+/**
+ * Violations recorded since start or the last reset. Safe from any thread.
+ *
+ * @return The count, or -1 if the checker is not compiled in
+ */
+long long getViolationCount();
+
+/**
+ * Forget all recorded violations.
+ */
+void resetViolations();
+
+/**
+ * Print the count and one line per distinct stage, kind and caller.
+ * Control thread only.
+ *
+ * @param out The stream to print to
+ */
+void printReport(std::FILE* out);
+
+} // namespace rtsafety
+
+#define SYNTH_RT_CONCAT_INNER(a, b) a##b
+#define SYNTH_RT_CONCAT(a, b) SYNTH_RT_CONCAT_INNER(a, b)
+
+#ifdef SYNTH_RT_SAFETY_CHECKS
+#define SYNTH_RT_AUDIO_THREAD(tag) rtsafety::AudioThreadScope SYNTH_RT_CONCAT(rtAudioScope, __LINE__)(tag)
+#define SYNTH_RT_STAGE(tag) rtsafety::StageTag SYNTH_RT_CONCAT(rtStageTag, __LINE__)(tag)
+#else
+#define SYNTH_RT_AUDIO_THREAD(tag) ((void)0)
+#define SYNTH_RT_STAGE(tag) ((void)0)
+#endif
+
+#endif // RT_SAFETY_H
@@ -0,0 +1,73 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Wait-free single-producer single-consumer ring buffer.
+ *
+ * One thread may push and one other thread may pop concurrently without
+ * locks; both operations finish in a bounded number of steps and never
+ * allocate. Several producers must serialize among themselves.
+ *
+ * @tparam T Trivially copyable item type
+ * @tparam Capacity Number of slots, a power of two
+ */
+template <typename T, int Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /**
+     * Add an item. Producer thread only.
+     *
+     * @param item The item to copy into the queue
+     * @return True on success, false if the queue is full
+     */
+    bool push(const T& item) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == static_cast<uint32_t>(Capacity)) {
+            return false;
+        }
+        items_[tail & kMask] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove the oldest item. Consumer thread only.
+     *
+     * @param item Receives the item
+     * @return True if an item was removed, false if the queue is empty
+     */
+    bool pop(T& item) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items_[head & kMask];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Check for pending items. Exact on the consumer thread, a snapshot elsewhere.
+     *
+     * @return True if the queue is empty
+     */
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr uint32_t kMask = static_cast<uint32_t>(Capacity - 1);
+
+    // Producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<uint32_t> head_{0};
+    alignas(64) std::atomic<uint32_t> tail_{0};
+    alignas(64) std::array<T, Capacity> items_{};
+};
+
+#endif // SPSC_QUEUE_H
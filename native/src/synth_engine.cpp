@@ -4,12 +4,21 @@
 #include "synthesis/envelope.h"
 #include "synthesis/delay.h"
 #include "synthesis/reverb.h"
+#include "synthesis/voice_pool.h"
+#include "synthesis/multi_voice_oscillator.h"
+#include "synthesis/voice_worker_pool.h"
+#include "synthesis/denormals.h"
 #include "audio_platform/audio_platform.h"
 #include "wavetable/wavetable_manager.h"
 #include "wavetable/wavetable_oscillator_impl.h"
 #include "granular/granular_synth.h"
+#include "wav_recorder.h"
+#include "rt_safety.h"
+#include "profiler.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <random>
 
 // SynthEngine implementation
 SynthEngine& SynthEngine::getInstance() {
@@ -26,7 +35,7 @@ SynthEngine::~SynthEngine() {
     shutdown();
 }
 
-bool SynthEngine::initialize(int sr, int bs, float initialVolume) {
+bool SynthEngine::initialize(int sr, int bs, float initialVolume, bool openAudioDevice) {
     if (initialized) {
         return true; // Already initialized
     }
@@ -35,6 +44,17 @@ bool SynthEngine::initialize(int sr, int bs, float initialVolume) {
         sampleRate = sr;
         bufferSize = bs;
         masterVolume = initialVolume;
+        appliedVolume = initialVolume;
+        smoothingSamples = static_cast<int>(smoothingTime * 0.001f * sampleRate);
+        smoothingCount = 0;
+        smoothing.fill(false);
+        modulation.reset();
+        modulation.setSampleRate(sampleRate);
+        modulatedCount = 0;
+        sampleClock.store(0);
+        pendingEvents.store(0);
+        loadMeter.setSampleRate(sampleRate);
+        loadMeter.clear();
         
         // Initialize wavetable manager
         wavetableManager = std::make_unique<synth::WavetableManager>();
@@ -45,6 +65,20 @@ bool SynthEngine::initialize(int sr, int bs, float initialVolume) {
         
         // Initialize modules
         initializeDefaultModules();
+        recorder = std::make_unique<WavRecorder>();
+        
+        // Seed the parameter store with the module defaults
+        for (int id = 0; id < ParameterStore::kNumParameters; ++id) {
+            parameterBase[id] = readParameter(id, 0.0f);
+            parameters.reset(id, parameterBase[id]);
+            parameters.setKnown(id, isKnownParameter(id));
+        }
+        
+        if (!openAudioDevice) {
+            // Headless: the caller renders with renderFrames()
+            initialized = true;
+            return true;
+        }
         
         // Create audio platform
         audioPlatform = AudioPlatform::createForCurrentPlatform();
@@ -89,131 +123,468 @@ void SynthEngine::shutdown() {
         audioPlatform->stop();
     }
     
+    // The audio thread is gone; free whatever is still in flight
+    discardCommands();
+    
+    // Finish writing any recording
+    recorder.reset();
+    
     // Clean up all modules
     oscillators.clear();
     filter.reset();
     envelope.reset();
-    delay.reset();
-    reverb.reset();
+    workerPool.reset();
+    voicePool.reset();
+    events.clear();
+    pendingEvents.store(0);
+    for (auto& d : delay) {
+        d.reset();
+    }
+    for (auto& r : reverb) {
+        r.reset();
+    }
     wavetableManager.reset();
     granularSynth.reset();
     
     // Clear audio platform
     audioPlatform.reset();
     
-    // Clear active notes
-    {
-        std::lock_guard<std::mutex> lock(notesMutex);
-        activeNotes.clear();
-    }
-    
-    // Clear parameter cache
-    {
-        std::lock_guard<std::mutex> lock(parameterMutex);
-        parameterCache.clear();
+    // Debug builds with the real-time safety checker report what the
+    // audio thread did wrong
+    if (rtsafety::getViolationCount() > 0) {
+        rtsafety::printReport(stdout);
     }
     
     initialized = false;
 }
 
 void SynthEngine::processAudio(float* outputBuffer, int numFrames, int numChannels) {
-    if (!initialized || masterMute) {
-        // Clear the output buffer if engine is not initialized or muted
-        for (int i = 0; i < numFrames * numChannels; ++i) {
-            outputBuffer[i] = 0.0f;
+    SYNTH_RT_AUDIO_THREAD("processAudio");
+    SYNTH_PROFILE_THREAD(profiler, 0);
+    
+    if (!initialized) {
+        // Clear the output buffer if engine is not initialized
+        std::fill(outputBuffer, outputBuffer + numFrames * numChannels, 0.0f);
+        return;
+    }
+    
+    // Times the whole callback, whichever way it returns
+    DspLoadMeter::Scope loadScope(loadMeter, numFrames);
+    
+    // Apply everything the control threads changed since the last callback:
+    // parameters first, so a polyphony change precedes the notes after it.
+    // This is the only way control state reaches the audio thread, so no
+    // lock is ever taken here
+    {
+        SYNTH_PROFILE(Control);
+        parameters.applyRequested([this](int parameterId, float value) {
+            updateParameter(parameterId, value, true);
+        });
+        applyCommands();
+    }
+    
+    const uint64_t blockStart = sampleClock.load(std::memory_order_relaxed);
+    if (masterMute) {
+        // Keep the clock running so scheduled events are not held back
+        uint64_t eventTime = 0;
+        while (events.peekTime(eventTime) && eventTime < blockStart + numFrames) {
+            applyNextEvent();
+        }
+        std::fill(outputBuffer, outputBuffer + numFrames * numChannels, 0.0f);
+        sampleClock.store(blockStart + numFrames, std::memory_order_relaxed);
+        if (recorder) {
+            SYNTH_RT_STAGE("recorder");
+            recorder->write(outputBuffer, numFrames, numChannels);
         }
         return;
     }
     
-    // Process audio for each frame
-    for (int frame = 0; frame < numFrames; ++frame) {
-        float sampleLeft = 0.0f;
-        float sampleRight = 0.0f;
+    // Rank voices for quietest-first stealing once per callback
+    if (voicePool) {
+        voicePool->updateQuietOrder();
+    }
+    
+    // Render in sub-blocks that fit the scratch buffers, splitting the
+    // block wherever a scheduled event falls so it lands on its exact frame
+    int offset = 0;
+    while (offset < numFrames) {
+        uint64_t eventTime = 0;
+        {
+            SYNTH_PROFILE(Control);
+            while (events.peekTime(eventTime) && eventTime <= blockStart + offset) {
+                applyNextEvent(); // Events already due, or late, apply here
+            }
+        }
         
-        // Process all oscillators
-        for (auto& osc : oscillators) {
-            float oscSample = osc->process();
-            
-            // Apply envelope
-            if (envelope && envelope->isActive()) {
-                oscSample *= envelope->process();
+        // While parameters are ramping or modulated, step them once per
+        // control block
+        const bool modulating = modulatedCount > 0 || modulation.isActive();
+        const bool controlRate = smoothingCount > 0 || modulating;
+        int end = std::min(numFrames, offset + (controlRate ? kControlBlockSize : kMaxBlockSize));
+        if (events.peekTime(eventTime) && eventTime < blockStart + end) {
+            end = static_cast<int>(eventTime - blockStart);
+        }
+        if (controlRate) {
+            SYNTH_PROFILE(Modulation);
+            if (smoothingCount > 0) {
+                advanceSmoothers(end - offset);
             }
-            
-            // Apply filter
-            if (filter) {
-                oscSample = filter->process(oscSample);
+            if (modulating) {
+                applyModulation(end - offset);
             }
-            
-            // Add to output (simple stereo panning would go here)
-            sampleLeft += oscSample;
-            sampleRight += oscSample;
         }
+        renderBlock(outputBuffer + offset * numChannels, end - offset, numChannels);
+        offset = end;
+    }
+    sampleClock.store(blockStart + numFrames, std::memory_order_relaxed);
+    
+    if (voicePool) {
+        activeVoiceCount.store(voicePool->getActiveCount(), std::memory_order_relaxed);
+    }
+    
+    // Hand the block to the recorder, if recording; never blocks
+    if (recorder) {
+        SYNTH_RT_STAGE("recorder");
+        SYNTH_PROFILE(Output);
+        recorder->write(outputBuffer, numFrames, numChannels);
+    }
+    
+    // Update audio analysis
+    updateAudioAnalysis(outputBuffer, numFrames, numChannels);
+}
+
+bool SynthEngine::renderFrames(float* outputBuffer, int numFrames) {
+    if (!isHeadless()) {
+        return false; // The audio platform owns the audio thread
+    }
+    
+    // The caller's thread stands in for the audio thread
+    ScopedDenormalsDisabled noDenormals;
+    processAudio(outputBuffer, numFrames, 2);
+    return true;
+}
+
+void SynthEngine::renderBlock(float* outputBuffer, int numFrames, int numChannels) {
+    SYNTH_RT_STAGE("renderBlock");
+    std::fill(mixLeft, mixLeft + numFrames, 0.0f);
+    
+    // Recompute the shared filter coefficients once for all voices
+    if (filter) {
+        SYNTH_PROFILE(Filter);
+        filter->updateCoefficients();
+    }
+    
+    // Render the active voices in groups of SIMD lanes and sum into the mix
+    if (voicePool && envelope && filter) {
+        VoicePool& voices = *voicePool;
+        constexpr int kLanes = MultiVoiceOscillator::kLanes;
+        static_assert(VoicePool::kMaxVoices <= kMaxRenderVoices, "renderList is too small for the voice pool");
+        static_assert(VoiceWorkerPool::kMaxThreads <= kMaxRenderThreads, "not enough per-thread scratch");
+        static_assert(kMaxRenderThreads <= Profiler::kMaxThreads, "not enough profiler slots");
         
-        // Add granular synthesis if active
-        if (granularSynth) {
-            float granLeft = 0.0f, granRight = 0.0f;
-            granularSynth->process(granLeft, granRight);
-            sampleLeft += granLeft;
-            sampleRight += granRight;
+        int voiceCount = 0;
+        for (int v = voices.firstActive(); v >= 0; v = voices.nextActive(v)) {
+            renderList[voiceCount++] = v;
         }
+        const int numGroups = (voiceCount + kLanes - 1) / kLanes;
         
-        // Apply effects
-        if (delay) {
-            sampleLeft = delay->process(sampleLeft);
-            sampleRight = delay->process(sampleRight);
+        if (workerPool && numGroups > 1) {
+            // Every voice renders into its own slot and the slots are summed
+            // in voice order, so the mix is identical to the single-threaded one
+            auto task = [this, voiceCount, numFrames](int groupIndex, int thread) {
+                SYNTH_PROFILE_THREAD(profiler, thread);
+                const int first = groupIndex * MultiVoiceOscillator::kLanes;
+                const int groupSize = std::min(MultiVoiceOscillator::kLanes, voiceCount - first);
+                renderVoiceGroup(renderList + first, groupSize, numFrames,
+                                 voiceScratch[thread], voiceOutput + first * kMaxBlockSize);
+            };
+            workerPool->run(numGroups, task);
+            
+            for (int i = 0; i < voiceCount; ++i) {
+                const float* voiceSamples = voiceOutput + i * kMaxBlockSize;
+                for (int frame = 0; frame < numFrames; ++frame) {
+                    mixLeft[frame] += voiceSamples[frame];
+                }
+            }
+        } else {
+            for (int first = 0; first < voiceCount; first += kLanes) {
+                renderVoiceGroup(renderList + first, std::min(kLanes, voiceCount - first), numFrames,
+                                 voiceScratch[0], nullptr);
+            }
         }
         
-        if (reverb) {
-            sampleLeft = reverb->process(sampleLeft);
-            sampleRight = reverb->process(sampleRight);
+        // Return voices whose release has finished to the pool; done after
+        // rendering because the pool's lists are not shared between threads
+        for (int i = 0; i < voiceCount; ++i) {
+            if (!voices.isActive(renderList[i])) {
+                voices.freeVoice(renderList[i]);
+            }
         }
         
-        // Apply master volume
-        sampleLeft *= masterVolume;
-        sampleRight *= masterVolume;
-        
-        // Write to output buffer
-        if (numChannels == 1) {
-            // Mono output
-            outputBuffer[frame] = (sampleLeft + sampleRight) * 0.5f;
-        } else {
-            // Stereo output
-            outputBuffer[frame * numChannels] = sampleLeft;
-            outputBuffer[frame * numChannels + 1] = sampleRight;
+        // Every voice ramped oscillator gain and filter coefficients across
+        // this sub-block; the next one starts where they ended
+        for (auto& oscillator : oscillators) {
+            oscillator->settleVolume();
         }
+        filter->settleCoefficients();
     }
     
-    // Update audio analysis
-    updateAudioAnalysis(outputBuffer, numFrames, numChannels);
+    // Voices are mono (simple stereo panning would go here)
+    std::copy(mixLeft, mixLeft + numFrames, mixRight);
+    
+    // Add granular synthesis if active
+    if (granularSynth) {
+        SYNTH_PROFILE(Granular);
+        granularSynth->processBlock(granularLeft, granularRight, numFrames);
+        for (int frame = 0; frame < numFrames; ++frame) {
+            mixLeft[frame] += granularLeft[frame];
+            mixRight[frame] += granularRight[frame];
+        }
+    }
+    
+    // Apply effects, one instance per channel
+    SYNTH_RT_STAGE("effects");
+    if (delay[0] && delay[1]) {
+        SYNTH_PROFILE(Delay);
+        delay[0]->processBlock(mixLeft, numFrames);
+        delay[1]->processBlock(mixRight, numFrames);
+    }
+    
+    if (reverb[0] && reverb[1]) {
+        SYNTH_PROFILE(Reverb);
+        reverb[0]->processBlock(mixLeft, numFrames);
+        reverb[1]->processBlock(mixRight, numFrames);
+    }
+    
+    // Apply master volume and write to output buffer; the gain moves
+    // linearly across the sub-block so volume changes do not click
+    SYNTH_PROFILE(Output);
+    float volume = appliedVolume;
+    const float volumeStep = (masterVolume - appliedVolume) / static_cast<float>(numFrames);
+    appliedVolume = masterVolume;
+    if (numChannels == 1) {
+        // Mono output
+        for (int frame = 0; frame < numFrames; ++frame) {
+            volume += volumeStep;
+            outputBuffer[frame] = (mixLeft[frame] * volume + mixRight[frame] * volume) * 0.5f;
+        }
+    } else {
+        // Stereo output
+        for (int frame = 0; frame < numFrames; ++frame) {
+            volume += volumeStep;
+            outputBuffer[frame * numChannels] = mixLeft[frame] * volume;
+            outputBuffer[frame * numChannels + 1] = mixRight[frame] * volume;
+        }
+    }
 }
 
-bool SynthEngine::noteOn(int note, int velocity) {
-    if (!initialized) {
-        return false;
+void SynthEngine::renderVoiceGroup(const int* group, int groupSize, int numFrames,
+                                   VoiceScratch& scratch, float* output) {
+    static_assert(MultiVoiceOscillator::kLanes <= kMaxLanes, "laneBlock is too small for the SIMD width");
+    constexpr int kLanes = MultiVoiceOscillator::kLanes;
+    
+    VoicePool& voices = *voicePool;
+    const int numOscillators = std::min(activeOscillators, static_cast<int>(oscillators.size()));
+    float* laneBlock = scratch.laneBlock;
+    
+    // Oscillators with a vectorized kernel render all voices of the group at
+    // once into the lane-interleaved buffer; the rest run per voice below
+    bool anyLanes = false;
+    {
+        SYNTH_PROFILE(Oscillators);
+        for (int i = 0; i < numOscillators; ++i) {
+            const Oscillator& osc = *oscillators[i];
+            if (!MultiVoiceOscillator::supports(osc.getType())) {
+                continue;
+            }
+            if (!anyLanes) {
+                std::fill(laneBlock, laneBlock + numFrames * kLanes, 0.0f);
+                anyLanes = true;
+            }
+            
+            alignas(64) float phases[kLanes] = {};
+            alignas(64) float increments[kLanes] = {};
+            for (int lane = 0; lane < groupSize; ++lane) {
+                const int v = group[lane];
+                phases[lane] = voices.phase[i][v];
+                increments[lane] = osc.getPhaseIncrement(voices.frequency[v]);
+            }
+            MultiVoiceOscillator::renderLanes(osc, laneBlock, numFrames, phases, increments);
+            for (int lane = 0; lane < groupSize; ++lane) {
+                voices.phase[i][group[lane]] = phases[lane];
+            }
+        }
     }
     
-    try {
-        // Normalize velocity to 0.0-1.0
-        float normalizedVelocity = static_cast<float>(velocity) / 127.0f;
+    for (int lane = 0; lane < groupSize; ++lane) {
+        const int v = group[lane];
+        float* voiceBlock = output ? output + lane * kMaxBlockSize : scratch.voiceBlock;
         
-        // Set oscillator frequencies based on MIDI note
-        float frequency = noteToFrequency(note);
-        for (auto& osc : oscillators) {
-            osc->setFrequency(frequency);
+        if (anyLanes) {
+            for (int frame = 0; frame < numFrames; ++frame) {
+                voiceBlock[frame] = laneBlock[frame * kLanes + lane];
+            }
+        } else {
+            std::fill(voiceBlock, voiceBlock + numFrames, 0.0f);
+        }
+        {
+            SYNTH_PROFILE(Oscillators);
+            for (int i = 0; i < numOscillators; ++i) {
+                Oscillator& osc = *oscillators[i];
+                if (MultiVoiceOscillator::supports(osc.getType())) {
+                    continue;
+                }
+                osc.processVoiceBlock(voiceBlock, numFrames, voices.phase[i][v],
+                                      osc.getPhaseIncrement(voices.frequency[v]), voices.noiseState[v]);
+            }
         }
         
-        // Trigger envelope
-        if (envelope) {
-            envelope->noteOn(normalizedVelocity);
+        // Apply envelope
+        {
+            SYNTH_PROFILE(Envelope);
+            envelope->processVoiceBlock(scratch.envelopeBlock, numFrames, voices.envState[v], voices.envLevel[v],
+                                        voices.envTime[v], voices.envReleaseLevel[v], voices.velocity[v]);
+            for (int frame = 0; frame < numFrames; ++frame) {
+                voiceBlock[frame] *= scratch.envelopeBlock[frame];
+            }
         }
         
-        // Track active note
+        // Apply filter
         {
-            std::lock_guard<std::mutex> lock(notesMutex);
-            activeNotes[note] = normalizedVelocity;
+            SYNTH_PROFILE(Filter);
+            filter->processVoiceBlock(voiceBlock, numFrames, voices.filterLow[v], voices.filterBand[v]);
+        }
+        
+        if (!output) {
+            for (int frame = 0; frame < numFrames; ++frame) {
+                mixLeft[frame] += voiceBlock[frame];
+            }
+        }
+    }
+}
+
+bool SynthEngine::setRenderThreadCount(int threads) {
+    if (threads < 0 || threads > kMaxRenderThreads) {
+        return false;
+    }
+    if (threads == 0) {
+        threads = VoiceWorkerPool::defaultThreadCount();
+    }
+    
+    try {
+        // The workers start here; the audio thread only swaps the pointer
+        // and hands the old pool back to be joined on a control thread
+        std::unique_ptr<VoiceWorkerPool> pool;
+        if (threads > 1) {
+            pool = std::make_unique<VoiceWorkerPool>(threads);
         }
         
+        Command command;
+        command.type = Command::Type::SetWorkerPool;
+        command.pool = pool.get();
+        if (!pushCommand(command)) {
+            return false; // Command queue full
+        }
+        pool.release(); // Now owned by the audio thread
+        renderThreadCount.store(threads, std::memory_order_relaxed);
         return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in SynthEngine::setRenderThreadCount: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+int SynthEngine::getRenderThreadCount() const {
+    return renderThreadCount.load(std::memory_order_relaxed);
+}
+
+bool SynthEngine::pushCommand(const Command& command) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    collectRetired();
+    return commands.push(command);
+}
+
+void SynthEngine::collectRetired() {
+    // Called with controlMutex held; this thread is the retired queue's consumer
+    Retired item;
+    while (retired.pop(item)) {
+        delete item.pool;
+        delete item.buffer;
+    }
+}
+
+void SynthEngine::applyCommands() {
+    SYNTH_RT_STAGE("applyCommands");
+    Command command;
+    while (commands.pop(command)) {
+        switch (command.type) {
+            case Command::Type::Event:
+                applyEvent(command.event);
+                break;
+                
+            case Command::Type::Schedule:
+                events.push(command.event); // Cannot fail: scheduleEvent reserved the slot
+                break;
+                
+            case Command::Type::SetWorkerPool:
+                {
+                    Retired item;
+                    item.pool = workerPool.release();
+                    workerPool.reset(command.pool);
+                    // Cannot fail: at most kCommandQueueSize objects are in flight
+                    retired.push(item);
+                }
+                break;
+                
+            case Command::Type::SetGranularBuffer:
+                {
+                    if (granularSynth) {
+                        granularSynth->swapBuffer(*command.buffer);
+                    }
+                    Retired item;
+                    item.buffer = command.buffer;
+                    retired.push(item);
+                }
+                break;
+                
+            case Command::Type::SetRandomSeed:
+                if (voicePool) {
+                    voicePool->seedNoise(command.seed);
+                }
+                if (granularSynth) {
+                    granularSynth->setSeed(command.seed);
+                }
+                break;
+        }
+    }
+}
+
+void SynthEngine::discardCommands() {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    Command command;
+    while (commands.pop(command)) {
+        delete command.pool;
+        delete command.buffer;
+    }
+    collectRetired();
+}
+
+bool SynthEngine::noteOn(int note, int velocity) {
+    if (!initialized) {
+        return false;
+    }
+    
+    if (note < 0 || note >= 128) {
+        return false;
+    }
+    
+    try {
+        // Applied by the audio thread at the start of its next block
+        Command command;
+        command.event.type = ScheduledEvent::Type::NoteOn;
+        command.event.id = note;
+        command.event.value = static_cast<float>(velocity);
+        return pushCommand(command);
     } catch (const std::exception& e) {
         std::cerr << "Exception in SynthEngine::noteOn: " << e.what() << std::endl;
         return false;
@@ -228,32 +599,15 @@ bool SynthEngine::noteOff(int note) {
         return false;
     }
     
+    if (note < 0 || note >= 128) {
+        return false;
+    }
+    
     try {
-        // Check if this note is active
-        bool noteWasActive = false;
-        {
-            std::lock_guard<std::mutex> lock(notesMutex);
-            auto it = activeNotes.find(note);
-            if (it != activeNotes.end()) {
-                activeNotes.erase(it);
-                noteWasActive = true;
-            }
-        }
-        
-        if (noteWasActive) {
-            // If there are no more active notes, trigger envelope release
-            bool anyNotesActive = false;
-            {
-                std::lock_guard<std::mutex> lock(notesMutex);
-                anyNotesActive = !activeNotes.empty();
-            }
-            
-            if (!anyNotesActive && envelope) {
-                envelope->noteOff();
-            }
-        }
-        
-        return true;
+        Command command;
+        command.event.type = ScheduledEvent::Type::NoteOff;
+        command.event.id = note;
+        return pushCommand(command);
     } catch (const std::exception& e) {
         std::cerr << "Exception in SynthEngine::noteOff: " << e.what() << std::endl;
         return false;
@@ -263,6 +617,118 @@ bool SynthEngine::noteOff(int note) {
     }
 }
 
+bool SynthEngine::scheduleNoteOn(int note, int velocity, uint64_t sampleTime) {
+    if (!isValidNote(note, velocity)) {
+        return false;
+    }
+    
+    ScheduledEvent event;
+    event.sampleTime = sampleTime;
+    event.type = ScheduledEvent::Type::NoteOn;
+    event.id = note;
+    event.value = static_cast<float>(velocity);
+    return scheduleEvent(event);
+}
+
+bool SynthEngine::scheduleNoteOff(int note, uint64_t sampleTime) {
+    if (!isValidNote(note)) {
+        return false;
+    }
+    
+    ScheduledEvent event;
+    event.sampleTime = sampleTime;
+    event.type = ScheduledEvent::Type::NoteOff;
+    event.id = note;
+    return scheduleEvent(event);
+}
+
+bool SynthEngine::scheduleParameter(int parameterId, float value, uint64_t sampleTime) {
+    if (!parameters.isKnownId(parameterId) || std::isnan(value)) {
+        return false;
+    }
+    
+    ScheduledEvent event;
+    event.sampleTime = sampleTime;
+    event.type = ScheduledEvent::Type::Parameter;
+    event.id = parameterId;
+    event.value = value;
+    return scheduleEvent(event);
+}
+
+bool SynthEngine::scheduleEvent(const ScheduledEvent& event) {
+    if (!initialized) {
+        return false;
+    }
+    
+    // Reserve a slot in the event queue before queuing the command, so an
+    // accepted event is never dropped when the audio thread files it
+    if (pendingEvents.fetch_add(1, std::memory_order_relaxed) >= EventQueue::kCapacity) {
+        pendingEvents.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    try {
+        Command command;
+        command.type = Command::Type::Schedule;
+        command.event = event;
+        if (pushCommand(command)) {
+            return true;
+        }
+    } catch (...) {
+    }
+    pendingEvents.fetch_sub(1, std::memory_order_relaxed); // Command queue full
+    return false;
+}
+
+bool SynthEngine::startNote(int note, int velocity) {
+    // Normalize velocity to 0.0-1.0
+    float normalizedVelocity = static_cast<float>(velocity) / 127.0f;
+    
+    // Start a voice at the note frequency; the pool is preallocated,
+    // so this never allocates
+    modulation.noteOn(note);
+    
+    float frequency = noteToFrequency(note);
+    if (!voicePool || voicePool->noteOn(note, frequency, normalizedVelocity) < 0) {
+        return false; // Invalid note, or dropped by the steal policy
+    }
+    return true;
+}
+
+void SynthEngine::releaseNote(int note) {
+    // Release every voice holding this note
+    if (voicePool) {
+        voicePool->noteOff(note);
+    }
+    modulation.noteOff(note);
+}
+
+void SynthEngine::applyNextEvent() {
+    applyEvent(events.pop());
+    pendingEvents.fetch_sub(1, std::memory_order_relaxed); // Frees the slot for scheduleEvent
+}
+
+void SynthEngine::applyEvent(const ScheduledEvent& event) {
+    SYNTH_RT_STAGE("applyEvent");
+    try {
+        switch (event.type) {
+            case ScheduledEvent::Type::NoteOn:
+                startNote(event.id, static_cast<int>(event.value));
+                break;
+            case ScheduledEvent::Type::NoteOff:
+                releaseNote(event.id);
+                break;
+            case ScheduledEvent::Type::Parameter:
+                // Scheduled values land exactly on their frame, unsmoothed
+                parameters.overrideRequested(event.id, event.value);
+                updateParameter(event.id, event.value, false);
+                break;
+        }
+    } catch (...) {
+        // Never let a bad event escape the audio callback
+    }
+}
+
 bool SynthEngine::processMidiEvent(unsigned char status, unsigned char data1, unsigned char data2) {
     if (!initialized) {
         return false;
@@ -316,273 +782,629 @@ bool SynthEngine::setParameter(int parameterId, float value) {
         return false;
     }
     
-    try {
-        // Update parameter cache
-        {
-            std::lock_guard<std::mutex> lock(parameterMutex);
-            parameterCache[parameterId] = value;
+    if (!parameters.isKnownId(parameterId) || std::isnan(value)) {
+        return false; // Out of range, or no module handles this ID
+    }
+    
+    // A single store; the audio thread picks up the change at the start
+    // of its next block
+    parameters.request(parameterId, value);
+    return true;
+}
+
+void SynthEngine::updateParameter(int parameterId, float value, bool smooth) {
+    SYNTH_RT_STAGE("updateParameter");
+    if (isSmoothedParameter(parameterId)) {
+        SmoothedValue& smoother = smoothers[parameterId];
+        if (!smoothing[parameterId]) {
+            // Ramp from the value in use, without any modulation on top
+            smoother.reset(parameterBase[parameterId]);
+        }
+        smoother.setTarget(value, smooth ? smoothingSamples : 0);
+        if (smoother.isSmoothing()) {
+            if (!smoothing[parameterId]) {
+                smoothing[parameterId] = true;
+                smoothingIds[smoothingCount++] = parameterId;
+            }
+            return;
+        }
+    }
+    
+    applyBaseValue(parameterId, value);
+    if (!smooth) {
+        settleRamp(parameterId); // Exact jump, no ramp across the sub-block
+    }
+}
+
+void SynthEngine::settleRamp(int parameterId) {
+    switch (parameterId) {
+        case SynthParameterId::masterVolume:
+            appliedVolume = masterVolume;
+            return;
+        case SynthParameterId::filterCutoff:
+        case SynthParameterId::filterResonance:
+            if (filter) {
+                filter->updateCoefficients();
+                filter->settleCoefficients();
+            }
+            return;
+        default:
+            break;
+    }
+    
+    // Oscillator volume
+    if (parameterId >= SynthParameterId::oscillatorType && parameterId < SynthParameterId::lfoRate) {
+        const int oscIndex = (parameterId - SynthParameterId::oscillatorType) / 10;
+        const int paramOffset = (parameterId - SynthParameterId::oscillatorType) % 10;
+        if (paramOffset == 3 && oscIndex < static_cast<int>(oscillators.size())) {
+            oscillators[oscIndex]->settleVolume();
         }
+    }
+}
+
+void SynthEngine::applyBaseValue(int parameterId, float value) {
+    if (applyParameter(parameterId, value)) {
+        value = readParameter(parameterId, value);
+        parameters.setApplied(parameterId, value);
+    }
+    parameterBase[parameterId] = value;
+}
+
+void SynthEngine::advanceSmoothers(int numFrames) {
+    for (int i = 0; i < smoothingCount;) {
+        const int parameterId = smoothingIds[i];
+        SmoothedValue& smoother = smoothers[parameterId];
+        applyBaseValue(parameterId, smoother.advance(numFrames));
         
-        // Handle parameter based on ID
-        switch (parameterId) {
-            // Master parameters
-            case SynthParameterId::masterVolume:
-                masterVolume = value;
-                return true;
-                
-            case SynthParameterId::masterMute:
-                masterMute = (value >= 0.5f);
+        if (smoother.isSmoothing()) {
+            ++i;
+        } else {
+            // Ramp finished (or was cut short by a jump); drop it
+            smoothing[parameterId] = false;
+            smoothingIds[i] = smoothingIds[--smoothingCount];
+        }
+    }
+}
+
+void SynthEngine::applyModulation(int numFrames) {
+    modulation.advance(numFrames);
+    
+    int destinations[ModulationMatrix::kMaxRoutes];
+    float offsets[ModulationMatrix::kMaxRoutes];
+    const int count = modulation.computeOffsets(destinations, offsets);
+    
+    // Destinations no longer modulated go back to their base value
+    for (int i = 0; i < modulatedCount; ++i) {
+        const int parameterId = modulatedIds[i];
+        if (std::find(destinations, destinations + count, parameterId) == destinations + count) {
+            applyBaseValue(parameterId, parameterBase[parameterId]);
+        }
+    }
+    
+    // Offsets are the sources' values at the end of this control block;
+    // volume and filter destinations ramp there across the block
+    for (int i = 0; i < count; ++i) {
+        const int parameterId = destinations[i];
+        const float value = parameterBase[parameterId] + offsets[i];
+        if (applyParameter(parameterId, value)) {
+            parameters.setApplied(parameterId, readParameter(parameterId, value));
+        }
+        modulatedIds[i] = parameterId;
+    }
+    modulatedCount = count;
+}
+
+bool SynthEngine::isSmoothedParameter(int parameterId) {
+    switch (parameterId) {
+        case SynthParameterId::masterVolume:
+        case SynthParameterId::filterCutoff:
+        case SynthParameterId::filterResonance:
+        case SynthParameterId::reverbMix:
+        case SynthParameterId::delayTime:
+        case SynthParameterId::delayFeedback:
+        case SynthParameterId::granularAmplitude:
+            return true;
+        default:
+            break;
+    }
+    
+    // Oscillator volume and wavetable position
+    if (parameterId >= SynthParameterId::oscillatorType && parameterId < SynthParameterId::lfoRate) {
+        const int paramOffset = (parameterId - SynthParameterId::oscillatorType) % 10;
+        return paramOffset == 3 || paramOffset == 6;
+    }
+    return false;
+}
+
+bool SynthEngine::isKnownParameter(int parameterId) const {
+    // Mirrors the IDs applyParameter() handles
+    switch (parameterId) {
+        case SynthParameterId::masterVolume:
+        case SynthParameterId::masterMute:
+        case SynthParameterId::polyphony:
+        case SynthParameterId::voiceStealPolicy:
+        case SynthParameterId::parameterSmoothing:
+        case SynthParameterId::oscillatorCount:
+        case SynthParameterId::filterCutoff:
+        case SynthParameterId::filterResonance:
+        case SynthParameterId::filterType:
+        case SynthParameterId::attackTime:
+        case SynthParameterId::decayTime:
+        case SynthParameterId::sustainLevel:
+        case SynthParameterId::releaseTime:
+        case SynthParameterId::reverbMix:
+        case SynthParameterId::delayTime:
+        case SynthParameterId::delayFeedback:
+        case SynthParameterId::granularActive:
+        case SynthParameterId::granularGrainRate:
+        case SynthParameterId::granularGrainDuration:
+        case SynthParameterId::granularPosition:
+        case SynthParameterId::granularPitch:
+        case SynthParameterId::granularAmplitude:
+        case SynthParameterId::granularPositionVar:
+        case SynthParameterId::granularPitchVar:
+        case SynthParameterId::granularDurationVar:
+        case SynthParameterId::granularPan:
+        case SynthParameterId::granularPanVar:
+        case SynthParameterId::granularWindowType:
+            return true;
+        default:
+            break;
+    }
+    
+    // Modulation parameters
+    if (parameterId >= SynthParameterId::lfoRate) {
+        const int lfoOffset = parameterId - SynthParameterId::lfoRate;
+        const int envelopeOffset = parameterId - SynthParameterId::auxEnvelopeAttack;
+        const int routeOffset = parameterId - SynthParameterId::modRouteSource;
+        return (lfoOffset >= 0 && lfoOffset < ModulationMatrix::kNumLfos * 2) ||
+               (envelopeOffset >= 0 && envelopeOffset < ModulationMatrix::kNumEnvelopes * 4) ||
+               (routeOffset >= 0 && routeOffset < ModulationMatrix::kMaxRoutes * 3);
+    }
+    
+    // Type through wavetable position of each oscillator
+    if (parameterId >= SynthParameterId::oscillatorType) {
+        const int oscIndex = (parameterId - SynthParameterId::oscillatorType) / 10;
+        const int paramOffset = (parameterId - SynthParameterId::oscillatorType) % 10;
+        return oscIndex < static_cast<int>(oscillators.size()) && paramOffset <= 6;
+    }
+    return false;
+}
+
+bool SynthEngine::applyParameter(int parameterId, float value) {
+    // Handle parameter based on ID
+    switch (parameterId) {
+        // Master parameters
+        case SynthParameterId::masterVolume:
+            masterVolume = value;
+            return true;
+            
+        case SynthParameterId::masterMute:
+            masterMute = (value >= 0.5f);
+            return true;
+            
+        case SynthParameterId::polyphony:
+            if (voicePool) {
+                voicePool->setVoiceLimit(static_cast<int>(value));
                 return true;
-                
-            // Filter parameters
-            case SynthParameterId::filterCutoff:
-                if (filter) {
-                    filter->setCutoff(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::filterResonance:
-                if (filter) {
-                    filter->setResonance(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::filterType:
-                if (filter) {
-                    filter->setType(static_cast<int>(value));
-                    return true;
-                }
-                return false;
-                
-            // Envelope parameters
-            case SynthParameterId::attackTime:
-                if (envelope) {
-                    envelope->setAttack(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::decayTime:
-                if (envelope) {
-                    envelope->setDecay(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::sustainLevel:
-                if (envelope) {
-                    envelope->setSustain(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::releaseTime:
-                if (envelope) {
-                    envelope->setRelease(value);
-                    return true;
-                }
-                return false;
-                
-            // Effect parameters
-            case SynthParameterId::reverbMix:
-                if (reverb) {
-                    reverb->setMix(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::delayTime:
-                if (delay) {
-                    delay->setTime(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::delayFeedback:
-                if (delay) {
-                    delay->setFeedback(value);
-                    return true;
-                }
-                return false;
-                
-            // Granular parameters
-            case SynthParameterId::granularGrainRate:
-                if (granularSynth) {
-                    granularSynth->setGrainRate(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::granularGrainDuration:
-                if (granularSynth) {
-                    granularSynth->setGrainDuration(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::granularPosition:
-                if (granularSynth) {
-                    granularSynth->setPosition(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::granularPitch:
-                if (granularSynth) {
-                    granularSynth->setPitch(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::granularAmplitude:
-                if (granularSynth) {
-                    granularSynth->setAmplitude(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::granularPositionVar:
-                if (granularSynth) {
-                    granularSynth->setPositionVariation(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::granularPitchVar:
-                if (granularSynth) {
-                    granularSynth->setPitchVariation(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::granularDurationVar:
-                if (granularSynth) {
-                    granularSynth->setGrainDurationVariation(value);
-                    return true;
-                }
-                return false;
-                
-            case SynthParameterId::granularPan:
-                if (granularSynth) {
-                    granularSynth->setPan(value);
-                    return true;
+            }
+            return false;
+            
+        case SynthParameterId::voiceStealPolicy:
+            if (voicePool) {
+                voicePool->setStealPolicy(static_cast<int>(value));
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::parameterSmoothing:
+            // Ramps already running keep their length
+            smoothingTime = std::clamp(value, 0.0f, 1000.0f);
+            smoothingSamples = static_cast<int>(smoothingTime * 0.001f * sampleRate);
+            return true;
+            
+        case SynthParameterId::oscillatorCount:
+            activeOscillators = std::clamp(static_cast<int>(value), 1,
+                                           std::min(static_cast<int>(oscillators.size()), VoicePool::kMaxOscillators));
+            return true;
+            
+        // Filter parameters
+        case SynthParameterId::filterCutoff:
+            if (filter) {
+                filter->setCutoff(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::filterResonance:
+            if (filter) {
+                filter->setResonance(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::filterType:
+            if (filter) {
+                filter->setType(static_cast<int>(value));
+                return true;
+            }
+            return false;
+            
+        // Envelope parameters
+        case SynthParameterId::attackTime:
+            if (envelope) {
+                envelope->setAttack(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::decayTime:
+            if (envelope) {
+                envelope->setDecay(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::sustainLevel:
+            if (envelope) {
+                envelope->setSustain(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::releaseTime:
+            if (envelope) {
+                envelope->setRelease(value);
+                return true;
+            }
+            return false;
+            
+        // Effect parameters
+        case SynthParameterId::reverbMix:
+            if (reverb[0]) {
+                for (auto& r : reverb) {
+                    r->setMix(value);
                 }
-                return false;
-                
-            case SynthParameterId::granularPanVar:
-                if (granularSynth) {
-                    granularSynth->setPanVariation(value);
-                    return true;
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::delayTime:
+            if (delay[0]) {
+                for (auto& d : delay) {
+                    d->setTime(value);
                 }
-                return false;
-                
-            case SynthParameterId::granularWindowType:
-                if (granularSynth) {
-                    granularSynth->setWindowType(static_cast<synth::Grain::WindowType>(static_cast<int>(value)));
-                    return true;
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::delayFeedback:
+            if (delay[0]) {
+                for (auto& d : delay) {
+                    d->setFeedback(value);
                 }
-                return false;
+                return true;
+            }
+            return false;
+            
+        // Granular parameters
+        case SynthParameterId::granularActive:
+            // Stored for the app to read back; grains play whenever the
+            // granular synth has a buffer
+            return true;
+            
+        case SynthParameterId::granularGrainRate:
+            if (granularSynth) {
+                granularSynth->setGrainRate(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularGrainDuration:
+            if (granularSynth) {
+                granularSynth->setGrainDuration(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularPosition:
+            if (granularSynth) {
+                granularSynth->setPosition(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularPitch:
+            if (granularSynth) {
+                granularSynth->setPitch(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularAmplitude:
+            if (granularSynth) {
+                granularSynth->setAmplitude(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularPositionVar:
+            if (granularSynth) {
+                granularSynth->setPositionVariation(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularPitchVar:
+            if (granularSynth) {
+                granularSynth->setPitchVariation(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularDurationVar:
+            if (granularSynth) {
+                granularSynth->setGrainDurationVariation(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularPan:
+            if (granularSynth) {
+                granularSynth->setPan(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularPanVar:
+            if (granularSynth) {
+                granularSynth->setPanVariation(value);
+                return true;
+            }
+            return false;
+            
+        case SynthParameterId::granularWindowType:
+            if (granularSynth) {
+                granularSynth->setWindowType(static_cast<synth::Grain::WindowType>(static_cast<int>(value)));
+                return true;
+            }
+            return false;
+            
+        default:
+            if (parameterId >= SynthParameterId::lfoRate) {
+                return applyModulationParameter(parameterId, value);
+            }
+            
+            // Check if this is an oscillator parameter
+            if (parameterId >= SynthParameterId::oscillatorType && parameterId < SynthParameterId::oscillatorType + 1000) {
+                int oscIndex = (parameterId - SynthParameterId::oscillatorType) / 10;
+                int paramOffset = (parameterId - SynthParameterId::oscillatorType) % 10;
                 
-            default:
-                // Check if this is an oscillator parameter
-                if (parameterId >= SynthParameterId::oscillatorType && parameterId < SynthParameterId::oscillatorType + 1000) {
-                    int oscIndex = (parameterId - SynthParameterId::oscillatorType) / 10;
-                    int paramOffset = (parameterId - SynthParameterId::oscillatorType) % 10;
-                    
-                    if (oscIndex >= 0 && oscIndex < oscillators.size()) {
-                        switch (paramOffset) {
-                            case 0: // Type
-                                oscillators[oscIndex]->setType(static_cast<int>(value));
-                                return true;
-                            case 1: // Frequency
-                                oscillators[oscIndex]->setFrequency(value);
-                                return true;
-                            case 2: // Detune
-                                oscillators[oscIndex]->setDetune(value);
-                                return true;
-                            case 3: // Volume
-                                oscillators[oscIndex]->setVolume(value);
-                                return true;
-                            case 4: // Pan
-                                oscillators[oscIndex]->setPan(value);
-                                return true;
-                            case 5: // Wavetable Index
-                                if (auto wtOsc = dynamic_cast<synth::WavetableOscillatorImpl*>(oscillators[oscIndex].get())) {
-                                    auto tableNames = wavetableManager->getTableNames();
-                                    int tableIndex = static_cast<int>(value);
-                                    if (tableIndex >= 0 && tableIndex < tableNames.size()) {
-                                        wtOsc->selectWavetable(tableNames[tableIndex]);
-                                    }
-                                }
-                                return true;
-                            case 6: // Wavetable Position
-                                if (auto wtOsc = dynamic_cast<synth::WavetableOscillatorImpl*>(oscillators[oscIndex].get())) {
-                                    wtOsc->setWavetablePosition(value);
-                                }
-                                return true;
-                            default:
-                                return false;
-                        }
+                if (oscIndex >= 0 && oscIndex < static_cast<int>(oscillators.size())) {
+                    switch (paramOffset) {
+                        case 0: // Type
+                            oscillators[oscIndex]->setType(static_cast<int>(value));
+                            return true;
+                        case 1: // Frequency
+                            oscillators[oscIndex]->setFrequency(value);
+                            return true;
+                        case 2: // Detune
+                            oscillators[oscIndex]->setDetune(value);
+                            return true;
+                        case 3: // Volume
+                            oscillators[oscIndex]->setVolume(value);
+                            return true;
+                        case 4: // Pan
+                            oscillators[oscIndex]->setPan(value);
+                            return true;
+                        case 5: // Wavetable Index
+                            // Runs on the audio thread: an indexed lookup
+                            // and a pointer swap, no name strings
+                            if (auto wtOsc = dynamic_cast<synth::WavetableOscillatorImpl*>(oscillators[oscIndex].get())) {
+                                wtOsc->setWavetable(wavetableManager->getWavetable(static_cast<int>(value)));
+                            }
+                            return true;
+                        case 6: // Wavetable Position
+                            if (auto wtOsc = dynamic_cast<synth::WavetableOscillatorImpl*>(oscillators[oscIndex].get())) {
+                                wtOsc->setWavetablePosition(value);
+                            }
+                            return true;
+                        default:
+                            return false;
                     }
                 }
-                
-                // Unhandled parameter ID
-                return false;
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "Exception in SynthEngine::setParameter: " << e.what() << std::endl;
-        return false;
-    } catch (...) {
-        std::cerr << "Unknown exception in SynthEngine::setParameter" << std::endl;
-        return false;
+            }
+            
+            // Unhandled parameter ID
+            return false;
     }
 }
 
 float SynthEngine::getParameter(int parameterId) {
-    if (!initialized) {
+    if (!initialized || !ParameterStore::isValid(parameterId)) {
         return 0.0f;
     }
     
-    try {
-        // Check cache first
-        {
-            std::lock_guard<std::mutex> lock(parameterMutex);
-            auto it = parameterCache.find(parameterId);
-            if (it != parameterCache.end()) {
-                return it->second;
+    // The value the DSP is using, as last applied by the audio thread
+    return parameters.get(parameterId);
+}
+
+float SynthEngine::readParameter(int parameterId, float fallback) const {
+    switch (parameterId) {
+        // Master parameters
+        case SynthParameterId::masterVolume:
+            return masterVolume;
+        case SynthParameterId::masterMute:
+            return masterMute ? 1.0f : 0.0f;
+        case SynthParameterId::polyphony:
+            return voicePool ? static_cast<float>(voicePool->getVoiceLimit()) : fallback;
+        case SynthParameterId::voiceStealPolicy:
+            return voicePool ? static_cast<float>(voicePool->getStealPolicy()) : fallback;
+        case SynthParameterId::parameterSmoothing:
+            return smoothingTime;
+        case SynthParameterId::oscillatorCount:
+            return static_cast<float>(activeOscillators);
+            
+        // Filter parameters
+        case SynthParameterId::filterCutoff:
+            return filter ? filter->getCutoff() : fallback;
+        case SynthParameterId::filterResonance:
+            return filter ? filter->getResonance() : fallback;
+        case SynthParameterId::filterType:
+            return filter ? static_cast<float>(filter->getType()) : fallback;
+            
+        // Envelope parameters
+        case SynthParameterId::attackTime:
+            return envelope ? envelope->getAttack() : fallback;
+        case SynthParameterId::decayTime:
+            return envelope ? envelope->getDecay() : fallback;
+        case SynthParameterId::sustainLevel:
+            return envelope ? envelope->getSustain() : fallback;
+        case SynthParameterId::releaseTime:
+            return envelope ? envelope->getRelease() : fallback;
+            
+        // Effect parameters
+        case SynthParameterId::reverbMix:
+            return reverb[0] ? reverb[0]->getMix() : fallback;
+        case SynthParameterId::delayTime:
+            return delay[0] ? delay[0]->getTime() : fallback;
+        case SynthParameterId::delayFeedback:
+            return delay[0] ? delay[0]->getFeedback() : fallback;
+            
+        // Granular parameters
+        case SynthParameterId::granularGrainRate:
+            return granularSynth ? granularSynth->getGrainRate() : fallback;
+        case SynthParameterId::granularGrainDuration:
+            return granularSynth ? granularSynth->getGrainDuration() : fallback;
+        case SynthParameterId::granularPosition:
+            return granularSynth ? granularSynth->getPosition() : fallback;
+        case SynthParameterId::granularPitch:
+            return granularSynth ? granularSynth->getPitch() : fallback;
+        case SynthParameterId::granularAmplitude:
+            return granularSynth ? granularSynth->getAmplitude() : fallback;
+        case SynthParameterId::granularPositionVar:
+            return granularSynth ? granularSynth->getPositionVariation() : fallback;
+        case SynthParameterId::granularPitchVar:
+            return granularSynth ? granularSynth->getPitchVariation() : fallback;
+        case SynthParameterId::granularDurationVar:
+            return granularSynth ? granularSynth->getGrainDurationVariation() : fallback;
+        case SynthParameterId::granularPan:
+            return granularSynth ? granularSynth->getPan() : fallback;
+        case SynthParameterId::granularPanVar:
+            return granularSynth ? granularSynth->getPanVariation() : fallback;
+        case SynthParameterId::granularWindowType:
+            return granularSynth ? static_cast<float>(granularSynth->getWindowType()) : fallback;
+            
+        default:
+            break;
+    }
+    
+    if (parameterId >= SynthParameterId::lfoRate) {
+        return readModulationParameter(parameterId, fallback);
+    }
+    
+    // Oscillator parameters
+    if (parameterId >= SynthParameterId::oscillatorType) {
+        int oscIndex = (parameterId - SynthParameterId::oscillatorType) / 10;
+        int paramOffset = (parameterId - SynthParameterId::oscillatorType) % 10;
+        if (oscIndex < static_cast<int>(oscillators.size())) {
+            const Oscillator& osc = *oscillators[oscIndex];
+            switch (paramOffset) {
+                case 0: // Type
+                    return static_cast<float>(osc.getType());
+                case 1: // Frequency
+                    return osc.getFrequency();
+                case 2: // Detune
+                    return osc.getDetune();
+                case 3: // Volume
+                    return osc.getVolume();
+                case 4: // Pan
+                    return osc.getPan();
+                case 6: // Wavetable Position
+                    if (auto wtOsc = dynamic_cast<const synth::WavetableOscillatorImpl*>(&osc)) {
+                        return wtOsc->getWavetablePosition();
+                    }
+                    break;
+                default:
+                    break;
             }
         }
-        
-        // If not in cache, get the parameter directly
-        switch (parameterId) {
-            // Master parameters
-            case SynthParameterId::masterVolume:
-                return masterVolume;
-                
-            case SynthParameterId::masterMute:
-                return masterMute ? 1.0f : 0.0f;
-                
-            // Filter parameters
-            case SynthParameterId::filterCutoff:
-                return filter ? static_cast<float>(filter->getCutoff()) : 1000.0f;
-                
-            case SynthParameterId::filterResonance:
-                return filter ? filter->getResonance() : 0.5f;
-                
-            // Add other parameter getters as needed
-                
+    }
+    
+    // No readback for this parameter; report the value that was set
+    return fallback;
+}
+
+bool SynthEngine::applyModulationParameter(int parameterId, float value) {
+    // LFOs
+    const int lfoOffset = parameterId - SynthParameterId::lfoRate;
+    if (lfoOffset >= 0 && lfoOffset < ModulationMatrix::kNumLfos * 2) {
+        if (lfoOffset % 2 == 0) {
+            modulation.setLfoRate(lfoOffset / 2, value);
+        } else {
+            modulation.setLfoShape(lfoOffset / 2, static_cast<int>(value));
+        }
+        return true;
+    }
+    
+    // Auxiliary envelopes
+    const int envelopeOffset = parameterId - SynthParameterId::auxEnvelopeAttack;
+    if (envelopeOffset >= 0 && envelopeOffset < ModulationMatrix::kNumEnvelopes * 4) {
+        modulation.setEnvelopeStage(envelopeOffset / 4, envelopeOffset % 4, value);
+        return true;
+    }
+    
+    // Routes
+    const int routeOffset = parameterId - SynthParameterId::modRouteSource;
+    if (routeOffset >= 0 && routeOffset < ModulationMatrix::kMaxRoutes * 3) {
+        const int route = routeOffset / 3;
+        switch (routeOffset % 3) {
+            case 0: // Source
+                modulation.setRouteSource(route, static_cast<int>(value));
+                return true;
+            case 1: { // Destination; modulation parameters cannot be modulated
+                int destination = static_cast<int>(value);
+                if (!ParameterStore::isValid(destination) || destination >= SynthParameterId::lfoRate) {
+                    destination = -1;
+                }
+                modulation.setRouteDestination(route, destination);
+                return true;
+            }
+            default: // Amount
+                modulation.setRouteAmount(route, value);
+                return true;
+        }
+    }
+    
+    return false;
+}
+
+float SynthEngine::readModulationParameter(int parameterId, float fallback) const {
+    const int lfoOffset = parameterId - SynthParameterId::lfoRate;
+    if (lfoOffset >= 0 && lfoOffset < ModulationMatrix::kNumLfos * 2) {
+        return lfoOffset % 2 == 0 ? modulation.getLfoRate(lfoOffset / 2)
+                                  : static_cast<float>(modulation.getLfoShape(lfoOffset / 2));
+    }
+    
+    const int envelopeOffset = parameterId - SynthParameterId::auxEnvelopeAttack;
+    if (envelopeOffset >= 0 && envelopeOffset < ModulationMatrix::kNumEnvelopes * 4) {
+        return modulation.getEnvelopeStage(envelopeOffset / 4, envelopeOffset % 4);
+    }
+    
+    const int routeOffset = parameterId - SynthParameterId::modRouteSource;
+    if (routeOffset >= 0 && routeOffset < ModulationMatrix::kMaxRoutes * 3) {
+        const int route = routeOffset / 3;
+        switch (routeOffset % 3) {
+            case 0:
+                return static_cast<float>(modulation.getRouteSource(route));
+            case 1:
+                return static_cast<float>(modulation.getRouteDestination(route));
             default:
-                return 0.0f; // Unhandled parameter ID
+                return modulation.getRouteAmount(route);
         }
-    } catch (const std::exception& e) {
-        std::cerr << "Exception in SynthEngine::getParameter: " << e.what() << std::endl;
-        return 0.0f;
-    } catch (...) {
-        std::cerr << "Unknown exception in SynthEngine::getParameter" << std::endl;
-        return 0.0f;
     }
+    
+    return fallback;
 }
 
 void SynthEngine::initializeDefaultModules() {
@@ -604,6 +1426,20 @@ void SynthEngine::initializeDefaultModules() {
     osc2->setWavetableManager(wavetableManager.get());
     oscillators.push_back(std::move(osc2));
     
+    // Two more, left out of the voice mix until the oscillator count
+    // parameter brings them in
+    for (int i = 2; i < VoicePool::kMaxOscillators; ++i) {
+        auto extra = std::make_unique<synth::WavetableOscillatorImpl>();
+        extra->setSampleRate(sampleRate);
+        extra->setType(static_cast<int>(i == 2 ? Oscillator::WaveformType::Sawtooth
+                                               : Oscillator::WaveformType::Triangle));
+        extra->setVolume(0.2f);
+        extra->setDetune(i == 2 ? -5.0f : 0.0f);
+        extra->setWavetableManager(wavetableManager.get());
+        oscillators.push_back(std::move(extra));
+    }
+    activeOscillators = 2;
+    
     // Create filter
     filter = std::make_unique<Filter>();
     filter->setSampleRate(sampleRate);
@@ -619,18 +1455,33 @@ void SynthEngine::initializeDefaultModules() {
     envelope->setSustain(0.7f);
     envelope->setRelease(0.5f);
     
-    // Create effects
-    delay = std::make_unique<Delay>();
-    delay->setSampleRate(sampleRate);
-    delay->setTime(0.5f);
-    delay->setFeedback(0.3f);
-    delay->setMix(0.2f);
+    // Create the voice pool that holds per-voice oscillator, envelope and filter state
+    voicePool = std::make_unique<VoicePool>();
+    voicePool->seedNoise(std::random_device{}()); // Like the granular synth, until setRandomSeed()
+    
+    // Create effects, one instance per output channel
+    for (auto& d : delay) {
+        d = std::make_unique<Delay>();
+        d->setSampleRate(sampleRate);
+        d->setTime(0.5f);
+        d->setFeedback(0.3f);
+        d->setMix(0.2f);
+    }
+    
+    for (auto& r : reverb) {
+        r = std::make_unique<Reverb>();
+        r->setSampleRate(sampleRate);
+        r->setRoomSize(0.5f);
+        r->setDamping(0.5f);
+        r->setMix(0.2f);
+    }
     
-    reverb = std::make_unique<Reverb>();
-    reverb->setSampleRate(sampleRate);
-    reverb->setRoomSize(0.5f);
-    reverb->setDamping(0.5f);
-    reverb->setMix(0.2f);
+    // Start from the defaults rather than ramping to them in the first block
+    for (auto& oscillator : oscillators) {
+        oscillator->settleVolume();
+    }
+    filter->updateCoefficients();
+    filter->settleCoefficients();
 }
 
 float SynthEngine::noteToFrequency(int note) const {
@@ -644,7 +1495,17 @@ bool SynthEngine::loadGranularBuffer(const std::vector<float>& buffer) {
     }
     
     try {
-        granularSynth->setBuffer(buffer);
+        // Copy here; the audio thread swaps it in and hands the old buffer
+        // back to be freed on a control thread
+        auto copy = std::make_unique<std::vector<float>>(buffer);
+        
+        Command command;
+        command.type = Command::Type::SetGranularBuffer;
+        command.buffer = copy.get();
+        if (!pushCommand(command)) {
+            return false; // Command queue full
+        }
+        copy.release(); // Now owned by the audio thread
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Exception in SynthEngine::loadGranularBuffer: " << e.what() << std::endl;
@@ -655,6 +1516,72 @@ bool SynthEngine::loadGranularBuffer(const std::vector<float>& buffer) {
     }
 }
 
+bool SynthEngine::setRandomSeed(uint32_t seed) {
+    if (!initialized) {
+        return false;
+    }
+    
+    Command command;
+    command.type = Command::Type::SetRandomSeed;
+    command.seed = seed;
+    return pushCommand(command);
+}
+
+bool SynthEngine::startRecording(const std::string& path) {
+    if (!initialized || !recorder) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(controlMutex);
+    return recorder->start(path, sampleRate, 2);
+}
+
+void SynthEngine::stopRecording() {
+    if (!initialized || !recorder) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(controlMutex);
+    recorder->stop();
+}
+
+bool SynthEngine::isRecording() const {
+    return recorder && recorder->isRecording();
+}
+
+uint64_t SynthEngine::getRecordedFrames() const {
+    return recorder ? recorder->getRecordedFrames() : 0;
+}
+
+uint64_t SynthEngine::getDroppedRecordingFrames() const {
+    return recorder ? recorder->getDroppedFrames() : 0;
+}
+
+// Voice allocation statistics
+int SynthEngine::getActiveVoiceCount() const {
+    return activeVoiceCount.load(std::memory_order_relaxed);
+}
+
+uint64_t SynthEngine::getVoiceStealCount() const {
+    return voicePool ? voicePool->getStealCount() : 0;
+}
+
+uint64_t SynthEngine::getVoiceDropCount() const {
+    return voicePool ? voicePool->getDropCount() : 0;
+}
+
+double SynthEngine::getDspLoad() const {
+    return loadMeter.getLoad();
+}
+
+CallbackStats SynthEngine::getCallbackStats() const {
+    return loadMeter.getStats();
+}
+
+void SynthEngine::resetCallbackStats() {
+    loadMeter.requestReset();
+}
+
 // Audio analysis functions for visualization
 double SynthEngine::getBassLevel() const {
     return bassLevel.load();
@@ -677,6 +1604,8 @@ double SynthEngine::getDominantFrequency() const {
 }
 
 void SynthEngine::updateAudioAnalysis(const float* buffer, int numFrames, int numChannels) {
+    SYNTH_RT_STAGE("analysis");
+    SYNTH_PROFILE(Analysis);
     if (!buffer || numFrames <= 0) {
         return;
     }
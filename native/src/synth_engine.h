@@ -1,12 +1,21 @@
 #ifndef SYNTH_ENGINE_H
 #define SYNTH_ENGINE_H
 
+#include <array>
 #include <vector>
 #include <memory>
 #include <mutex>
 #include <atomic>
-#include <unordered_map>
 #include <functional>
+#include <string>
+#include <cstdint>
+#include "event_queue.h"
+#include "spsc_queue.h"
+#include "parameter_store.h"
+#include "dsp_load_meter.h"
+#include "profiler.h"
+#include "synthesis/smoothed_value.h"
+#include "synthesis/modulation_matrix.h"
 
 // Forward declarations
 class Oscillator;
@@ -14,7 +23,10 @@ class Filter;
 class Envelope;
 class Delay;
 class Reverb;
+class VoicePool;
+class VoiceWorkerPool;
 class AudioPlatform;
+class WavRecorder;
 
 namespace synth {
     class WavetableManager;
@@ -29,9 +41,13 @@ namespace synth {
  */
 class SynthEngine {
 public:
-    // Singleton pattern
+    // Shared instance behind the singleton FFI functions; further
+    // independent instances can be created directly
     static SynthEngine& getInstance();
     
+    SynthEngine();
+    ~SynthEngine();
+    
     // Delete copy and move operations
     SynthEngine(const SynthEngine&) = delete;
     SynthEngine& operator=(const SynthEngine&) = delete;
@@ -44,9 +60,11 @@ public:
      * @param sampleRate The sample rate to use (e.g., 44100, 48000)
      * @param bufferSize The buffer size to use
      * @param initialVolume The initial master volume (0.0 - 1.0)
+     * @param openAudioDevice False to run headless: no audio platform is
+     *                        created and audio is pulled with renderFrames()
      * @return True on success, false on failure
      */
-    bool initialize(int sampleRate, int bufferSize, float initialVolume);
+    bool initialize(int sampleRate, int bufferSize, float initialVolume, bool openAudioDevice = true);
     
     /**
      * Shut down the engine and clean up resources.
@@ -62,12 +80,60 @@ public:
      */
     void processAudio(float* outputBuffer, int numFrames, int numChannels);
     
+    /**
+     * Render audio offline, as fast as the CPU allows.
+     * 
+     * Only available on a headless engine, where the caller takes the
+     * place of the audio thread: control calls made before this one apply
+     * at its first frame and scheduled events at their exact frames. Must
+     * not be called from several threads at once.
+     * 
+     * @param outputBuffer Receives numFrames interleaved stereo frames
+     * @param numFrames Number of frames to render
+     * @return True on success, false if the engine is not headless
+     */
+    bool renderFrames(float* outputBuffer, int numFrames);
+    
+    /**
+     * Check whether the engine runs without an audio device.
+     * 
+     * @return True if headless, false if an audio platform drives it
+     */
+    bool isHeadless() const {
+        return initialized && !audioPlatform;
+    }
+    
+    /**
+     * Check the arguments of a note event, so callers can tell a bad
+     * argument from a full queue. Any thread.
+     * 
+     * @param note The MIDI note number
+     * @param velocity The note velocity, 0 for a note-off
+     * @return True if both are within 0-127
+     */
+    static bool isValidNote(int note, int velocity = 0) {
+        return note >= 0 && note < 128 && velocity >= 0 && velocity < 128;
+    }
+    
+    /**
+     * Check that an ID names a parameter the engine handles. Any thread.
+     * 
+     * @param parameterId The parameter ID
+     * @return True if setParameter() and scheduleParameter() accept it
+     */
+    bool isParameterId(int parameterId) const {
+        return parameters.isKnownId(parameterId);
+    }
+    
     /**
      * Handle a note-on event.
      * 
+     * Like all control calls, this only queues a command; the audio thread
+     * applies it at the start of its next block.
+     * 
      * @param note The MIDI note number (0-127)
      * @param velocity The note velocity (0-127)
-     * @return True on success, false on failure
+     * @return True if queued, false if the note is invalid or the queue is full
      */
     bool noteOn(int note, int velocity);
     
@@ -75,10 +141,56 @@ public:
      * Handle a note-off event.
      * 
      * @param note The MIDI note number (0-127)
-     * @return True on success, false on failure
+     * @return True if queued, false if the note is invalid or the queue is full
      */
     bool noteOff(int note);
     
+    /**
+     * Schedule a note-on at an exact sample time.
+     * 
+     * The event is applied by the audio thread at that frame of the engine
+     * sample clock; times already in the past apply at the start of the
+     * next block.
+     * 
+     * @param note The MIDI note number (0-127)
+     * @param velocity The note velocity (0-127)
+     * @param sampleTime The engine sample time, see getSampleTime()
+     * @return True on success, false if the note or velocity is invalid
+     *         or the event queue is full
+     */
+    bool scheduleNoteOn(int note, int velocity, uint64_t sampleTime);
+    
+    /**
+     * Schedule a note-off at an exact sample time.
+     * 
+     * @param note The MIDI note number (0-127)
+     * @param sampleTime The engine sample time, see getSampleTime()
+     * @return True on success, false if the note is invalid or the event
+     *         queue is full
+     */
+    bool scheduleNoteOff(int note, uint64_t sampleTime);
+    
+    /**
+     * Schedule a parameter change at an exact sample time.
+     * 
+     * @param parameterId The ID of the parameter to set
+     * @param value The new value for the parameter
+     * @param sampleTime The engine sample time, see getSampleTime()
+     * @return True on success, false if no parameter has this ID or the
+     *         event queue is full
+     */
+    bool scheduleParameter(int parameterId, float value, uint64_t sampleTime);
+    
+    /**
+     * Get the engine sample clock: the number of frames rendered since
+     * initialization, i.e. the time of the first frame of the next block.
+     * 
+     * @return The current sample time
+     */
+    uint64_t getSampleTime() const {
+        return sampleClock.load(std::memory_order_relaxed);
+    }
+    
     /**
      * Process a raw MIDI event.
      * 
@@ -92,15 +204,22 @@ public:
     /**
      * Set a parameter value.
      * 
+     * Costs a single atomic store, so continuous controllers can stream
+     * values freely; the audio thread applies the latest value at the
+     * start of its next block.
+     * 
      * @param parameterId The ID of the parameter to set
      * @param value The new value for the parameter
-     * @return True on success, false on failure
+     * @return True on success, false if no parameter has this ID or the value is NaN
      */
     bool setParameter(int parameterId, float value);
     
     /**
      * Get a parameter value.
      * 
+     * Returns the value the DSP is using, after clamping, as of the last
+     * audio block; a value set since then shows up after the next block.
+     * 
      * @param parameterId The ID of the parameter to get
      * @return The parameter value
      */
@@ -136,11 +255,101 @@ public:
     /**
      * Load an audio buffer for granular synthesis.
      * 
-     * @param buffer The audio buffer to load
-     * @return True on success, false on failure
+     * @param buffer The audio buffer to load; copied on the calling thread
+     * @return True if queued, false on failure
      */
     bool loadGranularBuffer(const std::vector<float>& buffer);
     
+    /**
+     * Reseed the random sources, the noise waveform and the granular
+     * variations, at the start of the next audio block. Every voice has
+     * its own noise stream, so the same seed and the same events render
+     * the same output with any number of render threads.
+     * 
+     * @param seed The seed
+     * @return True if queued, false if the command queue is full
+     */
+    bool setRandomSeed(uint32_t seed);
+    
+    /**
+     * Start recording the master output to a 32-bit float WAV file.
+     * 
+     * The audio thread only copies each block into a ring buffer; a
+     * background thread writes the file, so a slow disk costs dropped
+     * frames rather than audio glitches.
+     * 
+     * @param path The output file path; an existing file is overwritten
+     * @return True on success, false if already recording or the file
+     *         cannot be created
+     */
+    bool startRecording(const std::string& path);
+    
+    /**
+     * Stop recording and finalize the file. Does nothing if not recording.
+     */
+    void stopRecording();
+    
+    /**
+     * Recording state and statistics, safe to read from any thread.
+     */
+    bool isRecording() const;
+    uint64_t getRecordedFrames() const;
+    uint64_t getDroppedRecordingFrames() const;
+    
+    /**
+     * Set how many threads render voices.
+     * 
+     * Extra worker threads split the active voices between them inside
+     * each audio callback; the output is identical to single-threaded
+     * rendering. Meant for dense patches on desktop and server machines.
+     * 
+     * @param threads Thread count including the audio thread: 1 renders on
+     *                the audio thread only, 0 picks one per CPU core
+     * @return True on success, false if the count is out of range
+     */
+    bool setRenderThreadCount(int threads);
+    
+    /**
+     * Get the number of threads rendering voices.
+     * 
+     * @return The thread count including the audio thread
+     */
+    int getRenderThreadCount() const;
+    
+    /**
+     * Voice allocation statistics, safe to read from any thread.
+     */
+    int getActiveVoiceCount() const;
+    uint64_t getVoiceStealCount() const;
+    uint64_t getVoiceDropCount() const;
+    
+    /**
+     * Get how much of the buffer period the audio callback uses, smoothed
+     * over the last few callbacks. Safe to call from any thread.
+     * 
+     * @return The DSP load; 1.0 or more means the callback is overrunning
+     */
+    double getDspLoad() const;
+    
+    /**
+     * Get the callback timing statistics and load histogram since the
+     * engine started or the last reset. Safe to call from any thread.
+     * 
+     * @return The statistics
+     */
+    CallbackStats getCallbackStats() const;
+    
+    /**
+     * Clear the callback statistics; takes effect at the next callback.
+     */
+    void resetCallbackStats();
+    
+    /**
+     * Get this engine's render stage profiler, with one slot per render
+     * thread. Reading and resetting it is safe from any thread.
+     */
+    Profiler& getProfiler() { return profiler; }
+    
     /**
      * Audio analysis functions for visualization.
      */
@@ -151,10 +360,6 @@ public:
     double getDominantFrequency() const;
 
 private:
-    // Private constructor for singleton
-    SynthEngine();
-    ~SynthEngine();
-    
     // Engine state
     std::atomic<bool> initialized;
     int sampleRate;
@@ -165,22 +370,92 @@ private:
     // Audio platform
     std::unique_ptr<AudioPlatform> audioPlatform;
     
+    // Master output recorder; exists while the engine is initialized
+    std::unique_ptr<WavRecorder> recorder;
+    
     // Audio modules
+    // The oscillators, filter and envelope hold the shared settings;
+    // per-voice state lives in the voice pool
     std::vector<std::unique_ptr<Oscillator>> oscillators;
+    int activeOscillators = 2; // Leading oscillators mixed into each voice
     std::unique_ptr<Filter> filter;
     std::unique_ptr<Envelope> envelope;
-    std::unique_ptr<Delay> delay;
-    std::unique_ptr<Reverb> reverb;
+    std::array<std::unique_ptr<Delay>, 2> delay;   // One per output channel
+    std::array<std::unique_ptr<Reverb>, 2> reverb; // One per output channel
     std::unique_ptr<synth::WavetableManager> wavetableManager;
     std::unique_ptr<synth::GranularSynthesizer> granularSynth;
     
-    // Note tracking
-    std::unordered_map<int, float> activeNotes; // note -> velocity
-    std::mutex notesMutex;
+    // Voice allocation
+    std::unique_ptr<VoicePool> voicePool;
+    std::unique_ptr<VoiceWorkerPool> workerPool; // Null when rendering single-threaded
+    std::atomic<int> renderThreadCount{1};
+    std::atomic<int> activeVoiceCount{0};
     
-    // Parameter cache
-    std::unordered_map<int, float> parameterCache;
-    std::mutex parameterMutex;
+    // Callback timing, written by the audio thread only
+    DspLoadMeter loadMeter;
+    
+    // Stage timing per render thread; only recorded with SYNTH_PROFILING
+    Profiler profiler;
+    
+    // Control threads never touch audio state directly: they push fixed-size
+    // commands that the audio thread applies at the start of its next block.
+    // Objects the audio thread replaces come back through the retired queue
+    // to be freed on a control thread.
+    struct Command {
+        enum class Type : uint8_t {
+            Event,             // Apply event now
+            Schedule,          // Queue event for event.sampleTime
+            SetWorkerPool,     // Swap in pool (may be null)
+            SetGranularBuffer, // Swap in buffer
+            SetRandomSeed      // Reseed noise and granular variation
+        };
+        
+        Type type = Type::Event;
+        ScheduledEvent event;
+        VoiceWorkerPool* pool = nullptr;
+        std::vector<float>* buffer = nullptr;
+        uint32_t seed = 0;
+    };
+    struct Retired {
+        VoiceWorkerPool* pool = nullptr;
+        std::vector<float>* buffer = nullptr;
+    };
+    static constexpr int kCommandQueueSize = 1024;
+    SpscQueue<Command, kCommandQueueSize> commands;
+    SpscQueue<Retired, kCommandQueueSize> retired;
+    std::mutex controlMutex; // Serializes control threads; never taken by the audio thread
+    
+    // Scheduled events and the sample clock, owned by the audio thread
+    EventQueue events;
+    std::atomic<uint64_t> sampleClock{0};
+    std::atomic<int> pendingEvents{0}; // Accepted by scheduleEvent and not yet applied
+    
+    // Requested and applied values of every parameter
+    ParameterStore parameters;
+    
+    // Continuous parameters ramp to new values instead of jumping. Ramps
+    // advance once per control block, so module coefficients are
+    // recomputed at control rate rather than per sample or per call.
+    // Master volume, oscillator volume and the filter coefficients then
+    // move linearly across the block; the other continuous parameters
+    // step once per control block
+    static constexpr int kControlBlockSize = 32;
+    float smoothingTime = 20.0f; // Ramp length in milliseconds, 0 disables
+    int smoothingSamples = 0;
+    std::array<SmoothedValue, ParameterStore::kNumParameters> smoothers;
+    std::array<bool, ParameterStore::kNumParameters> smoothing{};
+    int smoothingIds[ParameterStore::kNumParameters];
+    int smoothingCount = 0;
+    float appliedVolume = 0.75f; // Master volume at the end of the last sub-block
+    
+    // Modulation is added to the base value of each destination, the value
+    // last applied from a set call or a smoothing ramp, once per control
+    // block. Continuous destinations take the same path as a smoothing
+    // ramp; discrete ones (mute, polyphony, types, wavetable index) step
+    ModulationMatrix modulation;
+    std::array<float, ParameterStore::kNumParameters> parameterBase{};
+    int modulatedIds[ModulationMatrix::kMaxRoutes];
+    int modulatedCount = 0;
     
     // Audio analysis data
     mutable std::atomic<double> bassLevel{0.0};
@@ -189,6 +464,31 @@ private:
     mutable std::atomic<double> amplitudeLevel{0.0};
     mutable std::atomic<double> dominantFrequency{0.0};
     
+    // Scratch buffers for block rendering; callbacks larger than
+    // kMaxBlockSize are rendered in several sub-blocks
+    static constexpr int kMaxBlockSize = 256;
+    alignas(64) float mixLeft[kMaxBlockSize];
+    alignas(64) float mixRight[kMaxBlockSize];
+    alignas(64) float granularLeft[kMaxBlockSize];
+    alignas(64) float granularRight[kMaxBlockSize];
+    
+    // Per-thread voice rendering scratch; laneBlock holds the lane-interleaved
+    // output of the vectorized oscillators for the largest supported SIMD width
+    static constexpr int kMaxLanes = 8;
+    static constexpr int kMaxRenderThreads = 8;
+    struct VoiceScratch {
+        alignas(64) float voiceBlock[kMaxBlockSize];
+        alignas(64) float envelopeBlock[kMaxBlockSize];
+        alignas(64) float laneBlock[kMaxBlockSize * kMaxLanes];
+    };
+    std::array<VoiceScratch, kMaxRenderThreads> voiceScratch;
+    
+    // Voices rendered this block, and their outputs when rendering on
+    // several threads
+    static constexpr int kMaxRenderVoices = 64;
+    int renderList[kMaxRenderVoices];
+    alignas(64) float voiceOutput[kMaxRenderVoices * kMaxBlockSize];
+    
     // Audio analysis filter states
     float bassFilterState{0.0f};
     float midFilterState{0.0f};
@@ -196,6 +496,29 @@ private:
     
     // Internal methods
     void initializeDefaultModules();
+    void renderBlock(float* outputBuffer, int numFrames, int numChannels);
+    bool pushCommand(const Command& command);
+    void collectRetired();
+    void applyCommands();
+    void discardCommands();
+    bool scheduleEvent(const ScheduledEvent& event);
+    void applyNextEvent();
+    void applyEvent(const ScheduledEvent& event);
+    bool startNote(int note, int velocity);
+    void releaseNote(int note);
+    bool applyParameter(int parameterId, float value);
+    void updateParameter(int parameterId, float value, bool smooth);
+    void advanceSmoothers(int numFrames);
+    void applyModulation(int numFrames);
+    void applyBaseValue(int parameterId, float value);
+    void settleRamp(int parameterId);
+    bool applyModulationParameter(int parameterId, float value);
+    float readModulationParameter(int parameterId, float fallback) const;
+    static bool isSmoothedParameter(int parameterId);
+    bool isKnownParameter(int parameterId) const;
+    float readParameter(int parameterId, float fallback) const;
+    void renderVoiceGroup(const int* group, int groupSize, int numFrames,
+                          VoiceScratch& scratch, float* output);
     float noteToFrequency(int note) const;
     void updateAudioAnalysis(const float* buffer, int numFrames, int numChannels);
 };
@@ -205,6 +528,9 @@ namespace SynthParameterId {
     // Master parameters
     constexpr int masterVolume = 0;
     constexpr int masterMute = 1;
+    constexpr int polyphony = 7;
+    constexpr int voiceStealPolicy = 8;
+    constexpr int parameterSmoothing = 9; // Ramp time in ms for continuous parameters
     
     // Filter parameters
     constexpr int filterCutoff = 10;
@@ -236,6 +562,9 @@ namespace SynthParameterId {
     constexpr int granularPanVar = 50;
     constexpr int granularWindowType = 51;
     
+    // Oscillators mixed into each voice, 1 - VoicePool::kMaxOscillators
+    constexpr int oscillatorCount = 90;
+    
     // Oscillator parameters (per oscillator)
     // For oscillator n, use: oscillatorType + (n * 10)
     constexpr int oscillatorType = 100;
@@ -245,6 +574,22 @@ namespace SynthParameterId {
     constexpr int oscillatorPan = 104;
     constexpr int oscillatorWavetableIndex = 105;
     constexpr int oscillatorWavetablePosition = 106;
+    
+    // Modulation parameters
+    // For LFO n, use: lfoRate + (n * 2)
+    constexpr int lfoRate = 200;
+    constexpr int lfoShape = 201;
+    
+    // For auxiliary envelope n, use: auxEnvelopeAttack + (n * 4)
+    constexpr int auxEnvelopeAttack = 210;
+    constexpr int auxEnvelopeDecay = 211;
+    constexpr int auxEnvelopeSustain = 212;
+    constexpr int auxEnvelopeRelease = 213;
+    
+    // For modulation route n, use: modRouteSource + (n * 3)
+    constexpr int modRouteSource = 220;      // 0 none, 1-4 LFO, 5-6 envelope
+    constexpr int modRouteDestination = 221; // Parameter ID below lfoRate, -1 none; discrete IDs step
+    constexpr int modRouteAmount = 222;      // Offset in destination units
 }
 
 #endif // SYNTH_ENGINE_H
\ No newline at end of file
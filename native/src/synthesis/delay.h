@@ -4,6 +4,7 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include "denormals.h"
 
 /**
  * A delay effect with feedback and filtering.
@@ -37,8 +38,9 @@ public:
         // Read from buffer with fractional delay
         float delayedSample = readFractional();
         
-        // Apply feedback lowpass filter to the delayed sample
-        feedbackFilter = (feedbackFilter * lowpassCoeff) + (delayedSample * (1.0f - lowpassCoeff));
+        // Apply feedback lowpass filter to the delayed sample; flushed so a
+        // silent tail decays to zero instead of into denormals
+        feedbackFilter = flushDenormal((feedbackFilter * lowpassCoeff) + (delayedSample * (1.0f - lowpassCoeff)));
         
         // Write to buffer with feedback
         buffer[writeIndex] = input + (feedbackFilter * feedback);
@@ -51,6 +53,53 @@ public:
         return input * (1.0f - mix) + delayedSample * mix;
     }
     
+    /**
+     * Process a block of samples in place.
+     * 
+     * Equivalent to calling process() per sample, but the read position
+     * is advanced incrementally instead of being recomputed every sample.
+     * 
+     * @param samples The samples to process
+     * @param numSamples The number of samples to process
+     */
+    void processBlock(float* samples, int numSamples) {
+        if (!buffer) return;
+        
+        // Apply a pending delay time change once for the whole block
+        if (readIndexDirty) {
+            updateReadIndex();
+            readIndexDirty = false;
+        }
+        
+        for (int i = 0; i < numSamples; ++i) {
+            float input = samples[i];
+            
+            // Read from buffer with fractional delay
+            int nextIndex = readIndex + 1;
+            if (nextIndex >= bufferSize) {
+                nextIndex = 0;
+            }
+            float sample1 = buffer[readIndex];
+            float delayedSample = sample1 + fracDelay * (buffer[nextIndex] - sample1);
+            
+            // Apply feedback lowpass filter to the delayed sample; flushed so a
+            // silent tail decays to zero instead of into denormals
+            feedbackFilter = flushDenormal((feedbackFilter * lowpassCoeff) + (delayedSample * (1.0f - lowpassCoeff)));
+            
+            // Write to buffer with feedback
+            buffer[writeIndex] = input + (feedbackFilter * feedback);
+            
+            // Both indices move one sample per step
+            if (++writeIndex >= bufferSize) {
+                writeIndex = 0;
+            }
+            readIndex = nextIndex;
+            
+            // Mix dry and wet signals
+            samples[i] = input * (1.0f - mix) + delayedSample * mix;
+        }
+    }
+    
     /**
      * Set the sample rate.
      * 
@@ -70,7 +119,7 @@ public:
      */
     void setTime(float time) {
         delayTime = std::clamp(time, 0.01f, maxDelayTime);
-        updateReadIndex();
+        readIndexDirty = true; // Read position is recomputed at the next block
     }
     
     /**
@@ -102,6 +151,33 @@ public:
         lowpassCoeff = std::exp(-2.0f * M_PI * freq / sampleRate);
     }
     
+    /**
+     * Get the delay time.
+     * 
+     * @return The delay time in seconds
+     */
+    float getTime() const {
+        return delayTime;
+    }
+    
+    /**
+     * Get the feedback amount.
+     * 
+     * @return The feedback amount (0.0 - 0.99)
+     */
+    float getFeedback() const {
+        return feedback;
+    }
+    
+    /**
+     * Get the wet/dry mix.
+     * 
+     * @return The mix amount (0.0 = dry, 1.0 = wet)
+     */
+    float getMix() const {
+        return mix;
+    }
+    
     /**
      * Clear the delay buffer.
      */
@@ -189,6 +265,7 @@ private:
     int bufferSize;
     int writeIndex;
     int readIndex;
+    bool readIndexDirty = true; // Delay time changed since the last block
 };
 
 #endif // DELAY_H
\ No newline at end of file
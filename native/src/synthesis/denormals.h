@@ -0,0 +1,94 @@
+#ifndef DENORMALS_H
+#define DENORMALS_H
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SYNTH_DENORMALS_SSE 1
+#include <xmmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SYNTH_DENORMALS_AARCH64 1
+#elif defined(__arm__) && defined(__ARM_FP)
+#define SYNTH_DENORMALS_ARM32 1
+#endif
+
+/**
+ * Denormal protection for the audio thread and the recursive DSP states.
+ *
+ * Decaying feedback paths (filter integrators, delay feedback, reverb
+ * damping) end up in the subnormal float range during silent tails, where
+ * many CPUs fall back to microcode and run tens of times slower. Two
+ * layers keep that from happening:
+ *
+ * - ScopedDenormalsDisabled switches the FPU of the current thread to
+ *   flush-to-zero (FTZ) and denormals-are-zero (DAZ) mode. Every audio
+ *   platform backend holds one for the duration of its callback.
+ * - flushDenormal() snaps tiny state values to zero, for targets without
+ *   an FTZ mode and for code run outside an audio callback.
+ */
+
+/**
+ * Values below this magnitude (about -300 dB) are treated as silence.
+ */
+constexpr float kDenormalThreshold = 1.0e-15f;
+
+/**
+ * Snap a recursive state value to zero once it has decayed to inaudibility.
+ * Compiles to a compare and mask, no branch.
+ *
+ * @param value The state value
+ * @return The value, or zero if its magnitude is below kDenormalThreshold
+ */
+inline float flushDenormal(float value) {
+    return std::fabs(value) < kDenormalThreshold ? 0.0f : value;
+}
+
+/**
+ * Enables FTZ/DAZ on the current thread and restores the previous mode
+ * when destroyed. A no-op on targets without a control register for it.
+ */
+class ScopedDenormalsDisabled {
+public:
+    ScopedDenormalsDisabled() {
+#if defined(SYNTH_DENORMALS_SSE)
+        // MXCSR bit 15 is FTZ, bit 6 is DAZ
+        savedState = _mm_getcsr();
+        _mm_setcsr(savedState | 0x8040u);
+#elif defined(SYNTH_DENORMALS_AARCH64) && !defined(_MSC_VER)
+        // FPCR bit 24 is FZ
+        uint64_t fpcr;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+        savedState = fpcr;
+        fpcr |= (1ull << 24);
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#elif defined(SYNTH_DENORMALS_ARM32)
+        // FPSCR bit 24 is FZ
+        uint32_t fpscr;
+        __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+        savedState = fpscr;
+        fpscr |= (1u << 24);
+        __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+#endif
+    }
+
+    ~ScopedDenormalsDisabled() {
+#if defined(SYNTH_DENORMALS_SSE)
+        _mm_setcsr(static_cast<unsigned int>(savedState));
+#elif defined(SYNTH_DENORMALS_AARCH64) && !defined(_MSC_VER)
+        uint64_t fpcr = savedState;
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#elif defined(SYNTH_DENORMALS_ARM32)
+        uint32_t fpscr = static_cast<uint32_t>(savedState);
+        __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+#endif
+    }
+
+    ScopedDenormalsDisabled(const ScopedDenormalsDisabled&) = delete;
+    ScopedDenormalsDisabled& operator=(const ScopedDenormalsDisabled&) = delete;
+
+private:
+    uint64_t savedState = 0;
+};
+
+#endif // DENORMALS_H
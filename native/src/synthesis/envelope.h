@@ -76,89 +76,106 @@ public:
      * @return The current envelope value (0.0 - 1.0)
      */
     float process() {
+        return processVoice(currentState, currentLevel, currentTime, releaseLevel, velocity);
+    }
+    
+    /**
+     * Advance an externally owned envelope state by one sample.
+     * 
+     * The voice pool keeps one envelope state per voice and uses this
+     * envelope only for its shared ADSR settings.
+     * 
+     * @param state The voice envelope state, updated in place
+     * @param level The voice envelope level, updated in place
+     * @param time The time spent in the current state (ms), updated in place
+     * @param relLevel The level at which the release phase started
+     * @param vel The voice velocity (0.0 - 1.0)
+     * @return The envelope value (0.0 - 1.0)
+     */
+    float processVoice(State& state, float& level, float& time, float relLevel, float vel) const {
         float output = 0.0f;
         float samplesPerMs = sampleRate / 1000.0f;
         
-        switch (currentState) {
+        switch (state) {
             case State::Attack: {
                 // Convert to milliseconds for more precise short attacks
                 float attackMs = attackTime * 1000.0f;
-                currentTime += 1.0f / samplesPerMs;
+                time += 1.0f / samplesPerMs;
                 
                 if (attackMs <= 0.0f) {
                     // Instant attack
-                    currentLevel = 1.0f * velocity;
-                    currentState = State::Decay;
-                    currentTime = 0.0f;
+                    level = 1.0f * vel;
+                    state = State::Decay;
+                    time = 0.0f;
                 } else {
                     // Apply attack curve
-                    float attackProgress = currentTime / attackMs;
+                    float attackProgress = time / attackMs;
                     if (attackProgress >= 1.0f) {
-                        currentLevel = 1.0f * velocity;
-                        currentState = State::Decay;
-                        currentTime = 0.0f;
+                        level = 1.0f * vel;
+                        state = State::Decay;
+                        time = 0.0f;
                     } else {
-                        currentLevel = applyCurve(attackProgress, attackCurve) * velocity;
+                        level = applyCurve(attackProgress, attackCurve) * vel;
                     }
                 }
-                output = currentLevel;
+                output = level;
                 break;
             }
                 
             case State::Decay: {
                 float decayMs = decayTime * 1000.0f;
-                currentTime += 1.0f / samplesPerMs;
+                time += 1.0f / samplesPerMs;
                 
                 if (decayMs <= 0.0f) {
                     // Instant decay
-                    currentLevel = sustainLevel * velocity;
-                    currentState = State::Sustain;
+                    level = sustainLevel * vel;
+                    state = State::Sustain;
                 } else {
                     // Apply decay curve
-                    float decayProgress = currentTime / decayMs;
+                    float decayProgress = time / decayMs;
                     if (decayProgress >= 1.0f) {
-                        currentLevel = sustainLevel * velocity;
-                        currentState = State::Sustain;
+                        level = sustainLevel * vel;
+                        state = State::Sustain;
                     } else {
                         float decayCurveValue = applyCurve(decayProgress, decayCurve);
-                        currentLevel = (1.0f - decayCurveValue * (1.0f - sustainLevel)) * velocity;
+                        level = (1.0f - decayCurveValue * (1.0f - sustainLevel)) * vel;
                     }
                 }
-                output = currentLevel;
+                output = level;
                 break;
             }
                 
             case State::Sustain:
-                currentLevel = sustainLevel * velocity;
-                output = currentLevel;
+                level = sustainLevel * vel;
+                output = level;
                 break;
                 
             case State::Release: {
                 float releaseMs = releaseTime * 1000.0f;
-                currentTime += 1.0f / samplesPerMs;
+                time += 1.0f / samplesPerMs;
                 
                 if (releaseMs <= 0.0f) {
                     // Instant release
-                    currentLevel = 0.0f;
-                    currentState = State::Idle;
+                    level = 0.0f;
+                    state = State::Idle;
                 } else {
                     // Apply release curve
-                    float releaseProgress = currentTime / releaseMs;
+                    float releaseProgress = time / releaseMs;
                     if (releaseProgress >= 1.0f) {
-                        currentLevel = 0.0f;
-                        currentState = State::Idle;
+                        level = 0.0f;
+                        state = State::Idle;
                     } else {
                         float releaseCurveValue = applyCurve(releaseProgress, releaseCurve);
-                        currentLevel = releaseLevel * (1.0f - releaseCurveValue);
+                        level = relLevel * (1.0f - releaseCurveValue);
                     }
                 }
-                output = currentLevel;
+                output = level;
                 break;
             }
                 
             case State::Idle:
             default:
-                currentLevel = 0.0f;
+                level = 0.0f;
                 output = 0.0f;
                 break;
         }
@@ -166,6 +183,47 @@ public:
         return output;
     }
     
+    /**
+     * Process a block of envelope values.
+     * 
+     * @param out The output buffer, overwritten with numSamples values
+     * @param numSamples The number of samples to process
+     */
+    void processBlock(float* out, int numSamples) {
+        processVoiceBlock(out, numSamples, currentState, currentLevel, currentTime, releaseLevel, velocity);
+    }
+    
+    /**
+     * Process a block of values for an externally owned envelope state.
+     * 
+     * Sustain and idle stretches are filled directly instead of stepping
+     * the state machine per sample.
+     * 
+     * @param out The output buffer, overwritten with numSamples values
+     * @param numSamples The number of samples to process
+     * @param state The voice envelope state, updated in place
+     * @param level The voice envelope level, updated in place
+     * @param time The time spent in the current state (ms), updated in place
+     * @param relLevel The level at which the release phase started
+     * @param vel The voice velocity (0.0 - 1.0)
+     */
+    void processVoiceBlock(float* out, int numSamples, State& state, float& level, float& time,
+                           float relLevel, float vel) const {
+        for (int i = 0; i < numSamples; ) {
+            if (state == State::Sustain) {
+                level = sustainLevel * vel;
+                std::fill(out + i, out + numSamples, level);
+                return;
+            }
+            if (state == State::Idle) {
+                level = 0.0f;
+                std::fill(out + i, out + numSamples, 0.0f);
+                return;
+            }
+            out[i++] = processVoice(state, level, time, relLevel, vel);
+        }
+    }
+    
     /**
      * Set the sample rate.
      * 
@@ -238,6 +296,42 @@ public:
         releaseCurve = type;
     }
     
+    /**
+     * Get the attack time.
+     * 
+     * @return The attack time in seconds
+     */
+    float getAttack() const {
+        return attackTime;
+    }
+    
+    /**
+     * Get the decay time.
+     * 
+     * @return The decay time in seconds
+     */
+    float getDecay() const {
+        return decayTime;
+    }
+    
+    /**
+     * Get the sustain level.
+     * 
+     * @return The sustain level (0.0 - 1.0)
+     */
+    float getSustain() const {
+        return sustainLevel;
+    }
+    
+    /**
+     * Get the release time.
+     * 
+     * @return The release time in seconds
+     */
+    float getRelease() const {
+        return releaseTime;
+    }
+    
     /**
      * Check if the envelope is currently active.
      * 
@@ -264,7 +358,7 @@ private:
      * @param curve The curve type to apply
      * @return The curved value (0.0 - 1.0)
      */
-    float applyCurve(float value, CurveType curve) {
+    float applyCurve(float value, CurveType curve) const {
         // Ensure value is in [0,1] range
         value = std::clamp(value, 0.0f, 1.0f);
         
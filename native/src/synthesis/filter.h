@@ -3,6 +3,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include "denormals.h"
 
 /**
  * A multi-mode filter class implementing a state-variable filter.
@@ -22,9 +23,10 @@ public:
     };
     
     Filter() : sampleRate(44100), cutoff(1000.0f), resonance(0.5f),
-               type(FilterType::LowPass), lowpass(0.0f), highpass(0.0f),
-               bandpass(0.0f), notch(0.0f), peak(0.0f), gain(1.0f) {
+               type(FilterType::LowPass), gain(1.0f), lowpass(0.0f),
+               bandpass(0.0f) {
         calculateCoefficients();
+        settleCoefficients();
     }
     
     ~Filter() = default;
@@ -36,31 +38,78 @@ public:
      * @return The filtered output sample
      */
     float process(float input) {
+        updateCoefficients();
+        settleCoefficients();
+        return processVoice(input, lowpass, bandpass);
+    }
+    
+    /**
+     * Process one sample through externally owned filter state.
+     * 
+     * The voice pool keeps one integrator pair per voice and uses this
+     * filter only for its shared coefficients and mode.
+     * 
+     * @param input The input sample
+     * @param low The voice lowpass integrator, updated in place
+     * @param band The voice bandpass integrator, updated in place
+     * @return The filtered output sample
+     */
+    float processVoice(float input, float& low, float& band) const {
         // State variable filter algorithm
-        
-        // Calculation of state-variable filter components
-        lowpass = lowpass + f * bandpass;
-        highpass = scale * input - lowpass - q * bandpass;
-        bandpass = bandpass + f * highpass;
-        notch = highpass + lowpass;
-        peak = lowpass - highpass;
+        low = low + f * band;
+        float high = scale * input - low - q * band;
+        band = band + f * high;
         
         // Select output based on filter type
         switch (type) {
             case FilterType::LowPass:
-                return lowpass;
+                return low;
             case FilterType::HighPass:
-                return highpass;
+                return high;
             case FilterType::BandPass:
-                return bandpass;
+                return band;
             case FilterType::Notch:
-                return notch;
+                return high + low;
             case FilterType::LowShelf:
-                return input + (lowpass - input) * gain;
+                return input + (low - input) * gain;
             case FilterType::HighShelf:
-                return input + (highpass - input) * gain;
+                return input + (high - input) * gain;
             default:
-                return lowpass;
+                return low;
+        }
+    }
+    
+    /**
+     * Process a block of samples in place.
+     * 
+     * @param buffer The samples to filter
+     * @param numSamples The number of samples to process
+     */
+    void processBlock(float* buffer, int numSamples) {
+        updateCoefficients();
+        processVoiceBlock(buffer, numSamples, lowpass, bandpass);
+        settleCoefficients();
+    }
+    
+    /**
+     * Process a block in place through externally owned filter state.
+     * 
+     * The filter mode is resolved once per block, not once per sample.
+     * Call updateCoefficients() once before a batch of voice blocks so
+     * that pending cutoff and resonance changes take effect; the
+     * coefficients ramp to them across the block, from where the last
+     * settleCoefficients() left them.
+     * 
+     * @param buffer The samples to filter
+     * @param numSamples The number of samples to process
+     * @param low The voice lowpass integrator, updated in place
+     * @param band The voice bandpass integrator, updated in place
+     */
+    void processVoiceBlock(float* buffer, int numSamples, float& low, float& band) const {
+        if (startF != f || startQ != q || startScale != scale) {
+            processVoiceBlockAs<true>(buffer, numSamples, low, band);
+        } else {
+            processVoiceBlockAs<false>(buffer, numSamples, low, band);
         }
     }
     
@@ -71,7 +120,7 @@ public:
      */
     void setSampleRate(int sr) {
         sampleRate = sr;
-        calculateCoefficients();
+        coefficientsDirty = true;
     }
     
     /**
@@ -81,7 +130,7 @@ public:
      */
     void setCutoff(float freq) {
         cutoff = std::clamp(freq, 20.0f, 20000.0f);
-        calculateCoefficients();
+        coefficientsDirty = true;
     }
     
     /**
@@ -91,7 +140,7 @@ public:
      */
     void setResonance(float res) {
         resonance = std::clamp(res, 0.0f, 1.0f);
-        calculateCoefficients();
+        coefficientsDirty = true;
     }
     
     /**
@@ -112,11 +161,36 @@ public:
         gain = g;
     }
     
+    /**
+     * Recompute the coefficients if the cutoff, resonance or sample rate
+     * changed since the last call.
+     * 
+     * Setters only mark the coefficients stale, so a stream of changes
+     * costs one sin/sqrt evaluation per block rather than one per call.
+     */
+    void updateCoefficients() {
+        if (coefficientsDirty) {
+            calculateCoefficients();
+            coefficientsDirty = false;
+        }
+    }
+    
+    /**
+     * End a coefficient ramp: the next block starts at the current
+     * coefficients. Call it after every voice has rendered a block, or
+     * right after updateCoefficients() to jump instead of ramping.
+     */
+    void settleCoefficients() {
+        startF = f;
+        startQ = q;
+        startScale = scale;
+    }
+    
     /**
      * Reset the filter state.
      */
     void reset() {
-        lowpass = highpass = bandpass = notch = peak = 0.0f;
+        lowpass = bandpass = 0.0f;
     }
     
     /**
@@ -156,6 +230,82 @@ public:
     }
     
 private:
+    /**
+     * Pick the block loop for the filter mode once per block.
+     */
+    template <bool Ramp>
+    void processVoiceBlockAs(float* buffer, int numSamples, float& low, float& band) const {
+        switch (type) {
+            case FilterType::HighPass:
+                processBlockAs<FilterType::HighPass, Ramp>(buffer, numSamples, low, band);
+                break;
+            case FilterType::BandPass:
+                processBlockAs<FilterType::BandPass, Ramp>(buffer, numSamples, low, band);
+                break;
+            case FilterType::Notch:
+                processBlockAs<FilterType::Notch, Ramp>(buffer, numSamples, low, band);
+                break;
+            case FilterType::LowShelf:
+                processBlockAs<FilterType::LowShelf, Ramp>(buffer, numSamples, low, band);
+                break;
+            case FilterType::HighShelf:
+                processBlockAs<FilterType::HighShelf, Ramp>(buffer, numSamples, low, band);
+                break;
+            case FilterType::LowPass:
+            default:
+                processBlockAs<FilterType::LowPass, Ramp>(buffer, numSamples, low, band);
+                break;
+        }
+    }
+    
+    /**
+     * Block loop for one filter mode; same math as processVoice(). With
+     * Ramp, the coefficients move linearly from the settled ones to the
+     * current ones across the block.
+     */
+    template <FilterType Mode, bool Ramp>
+    void processBlockAs(float* buffer, int numSamples, float& low, float& band) const {
+        float lp = low;
+        float bp = band;
+        float bf = Ramp ? startF : f;
+        float bq = Ramp ? startQ : q;
+        float bscale = Ramp ? startScale : scale;
+        const float inv = numSamples > 0 ? 1.0f / static_cast<float>(numSamples) : 0.0f;
+        const float fStep = (f - startF) * inv;
+        const float qStep = (q - startQ) * inv;
+        const float scaleStep = (scale - startScale) * inv;
+        
+        for (int i = 0; i < numSamples; ++i) {
+            if constexpr (Ramp) {
+                bf += fStep;
+                bq += qStep;
+                bscale += scaleStep;
+            }
+            float input = buffer[i];
+            lp = lp + bf * bp;
+            float hp = bscale * input - lp - bq * bp;
+            bp = bp + bf * hp;
+            
+            if constexpr (Mode == FilterType::HighPass) {
+                buffer[i] = hp;
+            } else if constexpr (Mode == FilterType::BandPass) {
+                buffer[i] = bp;
+            } else if constexpr (Mode == FilterType::Notch) {
+                buffer[i] = hp + lp;
+            } else if constexpr (Mode == FilterType::LowShelf) {
+                buffer[i] = input + (lp - input) * gain;
+            } else if constexpr (Mode == FilterType::HighShelf) {
+                buffer[i] = input + (hp - input) * gain;
+            } else {
+                buffer[i] = lp;
+            }
+        }
+        
+        // Once per block is enough to stop a decaying tail short of denormals
+        low = flushDenormal(lp);
+        band = flushDenormal(bp);
+    }
+    
     /**
      * Calculate filter coefficients based on current settings.
      */
@@ -185,17 +335,20 @@ private:
     FilterType type;
     float gain;
     
-    // Filter state variables
+    // Filter state variables (integrators of the state-variable filter)
     float lowpass;
-    float highpass;
     float bandpass;
-    float notch;
-    float peak;
     
     // Filter coefficients
     float f;  // Frequency coefficient
     float q;  // Resonance coefficient
     float scale; // Scale factor
+    bool coefficientsDirty = false;
+    
+    // Coefficients at the start of the block, see settleCoefficients()
+    float startF;
+    float startQ;
+    float startScale;
 };
 
 #endif // FILTER_H
\ No newline at end of file
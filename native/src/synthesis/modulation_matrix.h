@@ -0,0 +1,375 @@
+#ifndef MODULATION_MATRIX_H
+#define MODULATION_MATRIX_H
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Global modulation sources routed to engine parameters.
+ *
+ * A fixed set of LFOs and auxiliary ADSR envelopes is advanced once per
+ * control block; each route scales one source by an amount in the units
+ * of its destination parameter. The engine adds the summed offsets to the
+ * value the user set, so modulation never has to cross the FFI boundary.
+ *
+ * Sources are numbered for routing: 0 is no source, 1 to kNumLfos are the
+ * LFOs, and the envelopes follow.
+ */
+class ModulationMatrix {
+public:
+    static constexpr int kNumLfos = 4;
+    static constexpr int kNumEnvelopes = 2;
+    static constexpr int kMaxRoutes = 8;
+
+    static constexpr int kSourceNone = 0;
+    static constexpr int kSourceFirstLfo = 1;
+    static constexpr int kSourceFirstEnvelope = kSourceFirstLfo + kNumLfos;
+    static constexpr int kNumSources = kSourceFirstEnvelope + kNumEnvelopes;
+
+    enum class LfoShape {
+        Sine,
+        Triangle,
+        Sawtooth,
+        Square,
+        SampleAndHold
+    };
+
+    ModulationMatrix() {
+        reset();
+    }
+
+    /**
+     * Restore default settings, clear all routes and stop the envelopes.
+     */
+    void reset() {
+        for (int i = 0; i < kNumLfos; ++i) {
+            lfos[i] = Lfo();
+            lfos[i].randomState = 0x9E3779B9u * static_cast<uint32_t>(i + 1);
+        }
+        for (auto& env : envelopes) {
+            env = AuxEnvelope();
+        }
+        for (auto& route : routes) {
+            route = Route();
+        }
+        heldNotes.reset();
+    }
+
+    /**
+     * Set the sample rate.
+     *
+     * @param sr The new sample rate
+     */
+    void setSampleRate(int sr) {
+        sampleRate = sr;
+    }
+
+    /**
+     * Set the rate of an LFO.
+     *
+     * @param lfo The LFO index (0 to kNumLfos - 1)
+     * @param hz The rate in Hz (0.01 - 50)
+     */
+    void setLfoRate(int lfo, float hz) {
+        lfos[lfo].rate = std::clamp(hz, 0.01f, 50.0f);
+    }
+
+    float getLfoRate(int lfo) const {
+        return lfos[lfo].rate;
+    }
+
+    /**
+     * Set the waveform of an LFO.
+     *
+     * @param lfo The LFO index (0 to kNumLfos - 1)
+     * @param shape The shape as an integer, see LfoShape
+     */
+    void setLfoShape(int lfo, int shape) {
+        lfos[lfo].shape = static_cast<LfoShape>(std::clamp(shape, 0, static_cast<int>(LfoShape::SampleAndHold)));
+    }
+
+    int getLfoShape(int lfo) const {
+        return static_cast<int>(lfos[lfo].shape);
+    }
+
+    /**
+     * Set one stage of an auxiliary envelope.
+     *
+     * @param env The envelope index (0 to kNumEnvelopes - 1)
+     * @param stage 0 attack, 1 decay, 2 sustain, 3 release
+     * @param value Time in seconds, or the sustain level (0.0 - 1.0)
+     */
+    void setEnvelopeStage(int env, int stage, float value) {
+        AuxEnvelope& e = envelopes[env];
+        switch (stage) {
+            case 0: e.attack = std::max(0.001f, value); break;
+            case 1: e.decay = std::max(0.001f, value); break;
+            case 2: e.sustain = std::clamp(value, 0.0f, 1.0f); break;
+            case 3: e.release = std::max(0.001f, value); break;
+            default: break;
+        }
+    }
+
+    float getEnvelopeStage(int env, int stage) const {
+        const AuxEnvelope& e = envelopes[env];
+        switch (stage) {
+            case 0: return e.attack;
+            case 1: return e.decay;
+            case 2: return e.sustain;
+            case 3: return e.release;
+            default: return 0.0f;
+        }
+    }
+
+    /**
+     * Set the source of a route.
+     *
+     * @param route The route index (0 to kMaxRoutes - 1)
+     * @param source The source number, kSourceNone to disable the route
+     */
+    void setRouteSource(int route, int source) {
+        routes[route].source = std::clamp(source, kSourceNone, kNumSources - 1);
+    }
+
+    int getRouteSource(int route) const {
+        return routes[route].source;
+    }
+
+    /**
+     * Set the destination of a route.
+     *
+     * @param route The route index (0 to kMaxRoutes - 1)
+     * @param parameterId The destination parameter ID, or -1 for none;
+     *                    the caller validates the ID
+     */
+    void setRouteDestination(int route, int parameterId) {
+        routes[route].destination = parameterId;
+    }
+
+    int getRouteDestination(int route) const {
+        return routes[route].destination;
+    }
+
+    /**
+     * Set the depth of a route.
+     *
+     * @param route The route index (0 to kMaxRoutes - 1)
+     * @param amount The offset at full source output, in destination units
+     */
+    void setRouteAmount(int route, float amount) {
+        routes[route].amount = amount;
+    }
+
+    float getRouteAmount(int route) const {
+        return routes[route].amount;
+    }
+
+    /**
+     * Check whether any route currently modulates a parameter.
+     *
+     * @return True if at least one route is complete and has a non-zero amount
+     */
+    bool isActive() const {
+        for (const Route& route : routes) {
+            if (route.isActive()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Open the envelope gate for a note, retriggering the envelopes.
+     *
+     * @param note The MIDI note number (0-127)
+     */
+    void noteOn(int note) {
+        heldNotes.set(note & 127);
+        for (auto& env : envelopes) {
+            env.stage = AuxEnvelope::Stage::Attack;
+        }
+    }
+
+    /**
+     * Release a note; the envelopes release when no note is held.
+     *
+     * @param note The MIDI note number (0-127)
+     */
+    void noteOff(int note) {
+        heldNotes.reset(note & 127);
+        if (heldNotes.none()) {
+            for (auto& env : envelopes) {
+                if (env.stage != AuxEnvelope::Stage::Idle) {
+                    env.stage = AuxEnvelope::Stage::Release;
+                }
+            }
+        }
+    }
+
+    /**
+     * Advance every source by one control block.
+     *
+     * @param numSamples The length of the control block in samples
+     */
+    void advance(int numSamples) {
+        const float seconds = static_cast<float>(numSamples) / static_cast<float>(sampleRate);
+
+        for (Lfo& lfo : lfos) {
+            lfo.phase += lfo.rate * seconds;
+            if (lfo.phase >= 1.0f) {
+                lfo.phase -= std::floor(lfo.phase);
+                // New random step once per cycle
+                lfo.randomState = lfo.randomState * 1664525u + 1013904223u;
+                lfo.held = static_cast<float>(lfo.randomState >> 8) * (2.0f / 16777216.0f) - 1.0f;
+            }
+            lfo.value = evaluateLfo(lfo);
+        }
+
+        for (AuxEnvelope& env : envelopes) {
+            advanceEnvelope(env, seconds);
+        }
+    }
+
+    /**
+     * Get the current output of a source.
+     *
+     * @param source The source number
+     * @return -1 to 1 for LFOs, 0 to 1 for envelopes, 0 for no source
+     */
+    float getSourceValue(int source) const {
+        if (source >= kSourceFirstLfo && source < kSourceFirstEnvelope) {
+            return lfos[source - kSourceFirstLfo].value;
+        }
+        if (source >= kSourceFirstEnvelope && source < kNumSources) {
+            return envelopes[source - kSourceFirstEnvelope].level;
+        }
+        return 0.0f;
+    }
+
+    /**
+     * Sum the active routes per destination.
+     *
+     * @param destinations Receives each modulated parameter ID once
+     * @param offsets Receives the summed offset for each destination
+     * @return The number of destinations written, at most kMaxRoutes
+     */
+    int computeOffsets(int* destinations, float* offsets) const {
+        int count = 0;
+        for (const Route& route : routes) {
+            if (!route.isActive()) {
+                continue;
+            }
+            const float offset = route.amount * getSourceValue(route.source);
+
+            int slot = 0;
+            while (slot < count && destinations[slot] != route.destination) {
+                ++slot;
+            }
+            if (slot == count) {
+                destinations[count] = route.destination;
+                offsets[count] = 0.0f;
+                ++count;
+            }
+            offsets[slot] += offset;
+        }
+        return count;
+    }
+
+private:
+    struct Lfo {
+        float rate = 1.0f;
+        LfoShape shape = LfoShape::Sine;
+        float phase = 0.0f;     // 0 to 1
+        float value = 0.0f;     // Output at the end of the last control block
+        float held = 0.0f;      // Sample-and-hold output
+        uint32_t randomState = 1;
+    };
+
+    struct AuxEnvelope {
+        enum class Stage {
+            Idle,
+            Attack,
+            Decay,
+            Sustain,
+            Release
+        };
+
+        float attack = 0.01f;
+        float decay = 0.2f;
+        float sustain = 0.7f;
+        float release = 0.3f;
+        Stage stage = Stage::Idle;
+        float level = 0.0f;
+    };
+
+    struct Route {
+        int source = kSourceNone;
+        int destination = -1;
+        float amount = 0.0f;
+
+        bool isActive() const {
+            return source != kSourceNone && destination >= 0 && amount != 0.0f;
+        }
+    };
+
+    static float evaluateLfo(const Lfo& lfo) {
+        const float p = lfo.phase;
+        switch (lfo.shape) {
+            case LfoShape::Sine:
+                return std::sin(2.0f * static_cast<float>(M_PI) * p);
+            case LfoShape::Triangle:
+                return p < 0.5f ? 4.0f * p - 1.0f : 3.0f - 4.0f * p;
+            case LfoShape::Sawtooth:
+                return 2.0f * p - 1.0f;
+            case LfoShape::Square:
+                return p < 0.5f ? 1.0f : -1.0f;
+            case LfoShape::SampleAndHold:
+                return lfo.held;
+        }
+        return 0.0f;
+    }
+
+    // Linear segments, evaluated at control rate
+    static void advanceEnvelope(AuxEnvelope& env, float seconds) {
+        switch (env.stage) {
+            case AuxEnvelope::Stage::Idle:
+                env.level = 0.0f;
+                break;
+            case AuxEnvelope::Stage::Attack:
+                env.level += seconds / env.attack;
+                if (env.level >= 1.0f) {
+                    env.level = 1.0f;
+                    env.stage = AuxEnvelope::Stage::Decay;
+                }
+                break;
+            case AuxEnvelope::Stage::Decay:
+                env.level -= (1.0f - env.sustain) * seconds / env.decay;
+                if (env.level <= env.sustain) {
+                    env.level = env.sustain;
+                    env.stage = AuxEnvelope::Stage::Sustain;
+                }
+                break;
+            case AuxEnvelope::Stage::Sustain:
+                env.level = env.sustain;
+                break;
+            case AuxEnvelope::Stage::Release:
+                env.level -= seconds / env.release;
+                if (env.level <= 0.0f) {
+                    env.level = 0.0f;
+                    env.stage = AuxEnvelope::Stage::Idle;
+                }
+                break;
+        }
+    }
+
+    int sampleRate = 44100;
+    std::array<Lfo, kNumLfos> lfos;
+    std::array<AuxEnvelope, kNumEnvelopes> envelopes;
+    std::array<Route, kMaxRoutes> routes;
+    std::bitset<128> heldNotes;
+};
+
+#endif // MODULATION_MATRIX_H
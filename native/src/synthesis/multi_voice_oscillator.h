@@ -0,0 +1,194 @@
+#ifndef MULTI_VOICE_OSCILLATOR_H
+#define MULTI_VOICE_OSCILLATOR_H
+
+#include "oscillator.h"
+#include "simd.h"
+
+/**
+ * Vectorized oscillator kernels that render several voices at once.
+ *
+ * Each SIMD lane holds one voice's phase accumulator, so a group of
+ * kLanes voices sharing an oscillator's settings is advanced with one
+ * instruction stream. PolyBLEP corrections are computed for every lane
+ * and blended in with compare masks instead of branches.
+ *
+ * Oscillator remains the reference implementation: saw, square, pulse
+ * and triangle match it to within rounding, sine uses a polynomial
+ * accurate to about 1e-7. Noise and wavetable waveforms are not
+ * supported here and must be rendered per voice.
+ */
+class MultiVoiceOscillator {
+public:
+    static constexpr int kLanes = simd::kLanes;
+
+    /**
+     * Check whether a waveform has a vectorized kernel.
+     *
+     * @param type The waveform type
+     * @return True if renderLanes can render this waveform
+     */
+    static bool supports(Oscillator::WaveformType type) {
+#if defined(SYNTH_NO_SIMD)
+        (void)type;
+        return false;
+#else
+        switch (type) {
+            case Oscillator::WaveformType::Sine:
+            case Oscillator::WaveformType::Square:
+            case Oscillator::WaveformType::Triangle:
+            case Oscillator::WaveformType::Sawtooth:
+            case Oscillator::WaveformType::Pulse:
+                return true;
+            default:
+                return false;
+        }
+#endif
+    }
+
+    /**
+     * Render kLanes voices of an oscillator, adding into a lane-interleaved
+     * buffer. Unused lanes should be given a zero phase and increment.
+     *
+     * @param osc The oscillator providing waveform, volume ramp and pulse width
+     * @param out Buffer of numSamples * kLanes floats, out[frame * kLanes + lane]
+     * @param numSamples Number of frames to render
+     * @param phases kLanes phase accumulators, advanced in place
+     * @param increments kLanes phase increments per sample
+     */
+    static void renderLanes(const Oscillator& osc, float* out, int numSamples,
+                            float* phases, const float* increments) {
+        const float startVolume = osc.getRampVolume();
+        const float volumeStep = numSamples > 0 ? (osc.getVolume() - startVolume) / static_cast<float>(numSamples) : 0.0f;
+        const float pulseWidth = osc.getPulseWidth();
+        switch (osc.getType()) {
+            case Oscillator::WaveformType::Sine:
+                renderKernel<Oscillator::WaveformType::Sine>(out, numSamples, phases, increments, startVolume, volumeStep, pulseWidth);
+                break;
+            case Oscillator::WaveformType::Square:
+                renderKernel<Oscillator::WaveformType::Square>(out, numSamples, phases, increments, startVolume, volumeStep, pulseWidth);
+                break;
+            case Oscillator::WaveformType::Triangle:
+                renderKernel<Oscillator::WaveformType::Triangle>(out, numSamples, phases, increments, startVolume, volumeStep, pulseWidth);
+                break;
+            case Oscillator::WaveformType::Sawtooth:
+                renderKernel<Oscillator::WaveformType::Sawtooth>(out, numSamples, phases, increments, startVolume, volumeStep, pulseWidth);
+                break;
+            case Oscillator::WaveformType::Pulse:
+                renderKernel<Oscillator::WaveformType::Pulse>(out, numSamples, phases, increments, startVolume, volumeStep, pulseWidth);
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    template <Oscillator::WaveformType Type>
+    static void renderKernel(float* out, int numSamples, float* phases, const float* increments,
+                             float startVolume, float volumeStep, float pulseWidth) {
+        using simd::Vec;
+        const Vec one = simd::set1(1.0f);
+        const Vec dt = simd::load(increments);
+        // Clamp so padded lanes with a zero increment stay finite
+        const Vec invDt = one / simd::max(dt, simd::set1(1.0e-12f));
+        const Vec gainStep = simd::set1(volumeStep);
+        Vec gain = simd::set1(startVolume);
+        const Vec pulseOffset = simd::set1(1.0f - pulseWidth);
+        const Vec width = simd::set1(pulseWidth);
+        Vec t = simd::load(phases);
+
+        for (int i = 0; i < numSamples; ++i) {
+            float* frame = out + i * kLanes;
+            Vec sample;
+            if constexpr (Type == Oscillator::WaveformType::Sine) {
+                sample = sine(t);
+            } else if constexpr (Type == Oscillator::WaveformType::Square) {
+                sample = square(t, dt, invDt);
+            } else if constexpr (Type == Oscillator::WaveformType::Triangle) {
+                sample = triangle(t);
+            } else if constexpr (Type == Oscillator::WaveformType::Sawtooth) {
+                sample = sawtooth(t, dt, invDt);
+            } else {
+                sample = pulse(t, dt, invDt, width, pulseOffset);
+            }
+            gain = gain + gainStep;
+            simd::store(frame, simd::load(frame) + sample * gain);
+
+            t = t + dt;
+            t = simd::select(t >= one, t - one, t);
+        }
+
+        simd::store(phases, t);
+    }
+
+    /**
+     * Wrap a phase known to lie in [0, 2) back into [0, 1).
+     */
+    static simd::Vec wrap(simd::Vec t) {
+        const simd::Vec one = simd::set1(1.0f);
+        return simd::select(t >= one, t - one, t);
+    }
+
+    /**
+     * PolyBLEP residual for all lanes; both edge polynomials are evaluated
+     * and the matching one selected per lane.
+     */
+    static simd::Vec polyBLEP(simd::Vec t, simd::Vec dt, simd::Vec invDt) {
+        const simd::Vec one = simd::set1(1.0f);
+        const simd::Vec zero = simd::set1(0.0f);
+
+        const simd::Vec x0 = t * invDt;
+        const simd::Vec rising = x0 + x0 - x0 * x0 - one;
+        const simd::Vec x1 = (t - one) * invDt;
+        const simd::Vec falling = x1 * x1 + x1 + x1 + one;
+
+        return simd::select(t < dt, rising, simd::select(t > one - dt, falling, zero));
+    }
+
+    static simd::Vec sine(simd::Vec t) {
+        // sin(2*pi*t) = -sin(pi*y) with y = 2t - 1, folded into [-0.5, 0.5]
+        const simd::Vec one = simd::set1(1.0f);
+        const simd::Vec half = simd::set1(0.5f);
+        simd::Vec y = t + t - one;
+        y = simd::select(y > half, one - y, y);
+        y = simd::select(y < simd::set1(-0.5f), simd::set1(-1.0f) - y, y);
+
+        // Taylor series of sin(z) to z^11, accurate to ~6e-8 for |z| <= pi/2
+        const simd::Vec z = y * simd::set1(3.14159265358979f);
+        const simd::Vec z2 = z * z;
+        simd::Vec p = simd::set1(-2.50521084e-8f);
+        p = p * z2 + simd::set1(2.75573192e-6f);
+        p = p * z2 - simd::set1(1.98412698e-4f);
+        p = p * z2 + simd::set1(8.33333333e-3f);
+        p = p * z2 - simd::set1(1.66666667e-1f);
+        p = p * z2 + one;
+        return simd::set1(0.0f) - z * p;
+    }
+
+    static simd::Vec square(simd::Vec t, simd::Vec dt, simd::Vec invDt) {
+        const simd::Vec one = simd::set1(1.0f);
+        const simd::Vec half = simd::set1(0.5f);
+        const simd::Vec value = simd::select(t < half, one, simd::set1(-1.0f));
+        return value - polyBLEP(t, dt, invDt) + polyBLEP(wrap(t + half), dt, invDt);
+    }
+
+    static simd::Vec triangle(simd::Vec t) {
+        const simd::Vec one = simd::set1(1.0f);
+        const simd::Vec half = simd::set1(0.5f);
+        // floor(t + 0.5) is either 0 or 1 for t in [0, 1)
+        const simd::Vec rounded = simd::select(t + half >= one, one, simd::set1(0.0f));
+        const simd::Vec saw = (t - rounded) * simd::set1(2.0f);
+        return (simd::abs(saw) - half) * simd::set1(2.0f);
+    }
+
+    static simd::Vec sawtooth(simd::Vec t, simd::Vec dt, simd::Vec invDt) {
+        return t + t - simd::set1(1.0f) - polyBLEP(t, dt, invDt);
+    }
+
+    static simd::Vec pulse(simd::Vec t, simd::Vec dt, simd::Vec invDt,
+                           simd::Vec width, simd::Vec pulseOffset) {
+        const simd::Vec value = simd::select(t < width, simd::set1(1.0f), simd::set1(-1.0f));
+        return value - polyBLEP(t, dt, invDt) + polyBLEP(wrap(t + pulseOffset), dt, invDt);
+    }
+};
+
+#endif // MULTI_VOICE_OSCILLATOR_H
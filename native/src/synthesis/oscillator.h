@@ -2,8 +2,8 @@
 #define OSCILLATOR_H
 
 #include <cmath>
+#include <cstdint>
 #include <vector>
-#include <random>
 
 /**
  * Base class for oscillator implementations
@@ -21,8 +21,8 @@ public:
     };
 
     Oscillator() : sampleRate(44100), frequency(440.0f), phase(0.0f), phaseIncrement(0.0f),
-                  volume(0.5f), detune(0.0f), pan(0.0f), pulseWidth(0.5f),
-                  waveformType(WaveformType::Sine), lastOutput(0.0f) {
+                  incrementPerHz(0.0f), volume(0.5f), rampVolume(0.5f), detune(0.0f), pan(0.0f), pulseWidth(0.5f),
+                  waveformType(WaveformType::Sine), lastOutput(0.0f), noiseState(noiseSeed(0, 0)) {
         updatePhaseIncrement();
     }
     
@@ -34,38 +34,7 @@ public:
      * @return The computed sample value
      */
     virtual float process() {
-        // Calculate base waveform
-        float sample = 0.0f;
-        
-        switch (waveformType) {
-            case WaveformType::Sine:
-                sample = processSine();
-                break;
-                
-            case WaveformType::Square:
-                sample = processSquare();
-                break;
-                
-            case WaveformType::Triangle:
-                sample = processTriangle();
-                break;
-                
-            case WaveformType::Sawtooth:
-                sample = processSawtooth();
-                break;
-                
-            case WaveformType::Noise:
-                sample = processNoise();
-                break;
-                
-            case WaveformType::Pulse:
-                sample = processPulse();
-                break;
-                
-            case WaveformType::Wavetable:
-                sample = processWavetable();
-                break;
-        }
+        float sample = renderWaveform(phase, phaseIncrement);
         
         // Update phase
         phase += phaseIncrement;
@@ -78,6 +47,45 @@ public:
         return lastOutput;
     }
     
+    /**
+     * Process a block of audio.
+     * 
+     * The waveform is resolved once per block and the samples are
+     * produced by a kernel specialized for it, so the per-sample loop
+     * has no waveform branch and no virtual calls.
+     * 
+     * @param out The output buffer, overwritten with numSamples samples
+     * @param numSamples The number of samples to process
+     */
+    virtual void processBlock(float* out, int numSamples) {
+        renderBlock<false>(out, numSamples, phase, phaseIncrement, noiseState);
+        settleVolume();
+        
+        if (numSamples > 0) {
+            lastOutput = out[numSamples - 1];
+        }
+    }
+    
+    /**
+     * Process a block for an externally owned phase accumulator.
+     * 
+     * The result is added to the output buffer so that all oscillators
+     * of a voice can be summed in place. Like processBlock(), the
+     * waveform kernel is chosen once per block. The gain ramps from the
+     * volume at the last settleVolume() to the current one, so call
+     * settleVolume() once every voice has rendered the block.
+     * 
+     * @param out The buffer to add numSamples samples to
+     * @param numSamples The number of samples to process
+     * @param voicePhase The voice phase (0.0 - 1.0), advanced in place
+     * @param voiceIncrement The voice phase increment per sample
+     * @param voiceNoise The voice noise generator state, advanced in place
+     */
+    virtual void processVoiceBlock(float* out, int numSamples, float& voicePhase, float voiceIncrement,
+                                   uint32_t& voiceNoise) {
+        renderBlock<true>(out, numSamples, voicePhase, voiceIncrement, voiceNoise);
+    }
+    
     /**
      * Set the sample rate.
      * 
@@ -117,6 +125,18 @@ public:
         volume = vol;
     }
     
+    /**
+     * End a volume ramp: the next block starts at the current volume.
+     * 
+     * Blocks ramp the gain linearly from the volume at the last call to
+     * the current one, so a volume change does not step. Call it after
+     * every voice has rendered a block, or right after setVolume() to
+     * jump instead of ramping.
+     */
+    void settleVolume() {
+        rampVolume = volume;
+    }
+    
     /**
      * Set the oscillator panning.
      * 
@@ -144,6 +164,34 @@ public:
         pulseWidth = width;
     }
     
+    /**
+     * Restart this oscillator's own noise generator, used by process() and
+     * processBlock(), so the noise it renders from here on is repeatable.
+     * 
+     * @param seed The generator seed
+     */
+    void seedNoise(uint32_t seed) {
+        noiseState = noiseSeed(seed, 0);
+    }
+    
+    /**
+     * Derive the starting state of one noise stream from a seed. Streams
+     * with different indices are decorrelated; the result is never zero.
+     * 
+     * @param seed The seed
+     * @param stream The stream index, e.g. a voice index
+     * @return A noise generator state
+     */
+    static uint32_t noiseSeed(uint32_t seed, int stream) {
+        uint32_t x = seed + 0x9E3779B9u * static_cast<uint32_t>(stream + 1);
+        x ^= x >> 16;
+        x *= 0x85EBCA6Bu;
+        x ^= x >> 13;
+        x *= 0xC2B2AE35u;
+        x ^= x >> 16;
+        return x != 0 ? x : 1u;
+    }
+    
     /**
      * Get the current frequency.
      * 
@@ -170,54 +218,239 @@ public:
     float getVolume() const {
         return volume;
     }
+    
+    /**
+     * Get the volume the next block's gain ramp starts from.
+     * 
+     * @return The volume at the last settleVolume()
+     */
+    float getRampVolume() const {
+        return rampVolume;
+    }
+
+    /**
+     * Get the current detune amount.
+     *
+     * @return The detune amount in cents
+     */
+    float getDetune() const {
+        return detune;
+    }
+
+    /**
+     * Get the current panning.
+     *
+     * @return The pan position (-1.0 = left, 0.0 = center, 1.0 = right)
+     */
+    float getPan() const {
+        return pan;
+    }
+
+    /**
+     * Get the current pulse width.
+     *
+     * @return The pulse width (0.0 - 1.0)
+     */
+    float getPulseWidth() const {
+        return pulseWidth;
+    }
+
+    /**
+     * Get the phase increment for a note frequency, including detune.
+     * 
+     * @param freq The note frequency in Hz
+     * @return The phase increment per sample
+     */
+    float getPhaseIncrement(float freq) const {
+        return freq * incrementPerHz;
+    }
 
 protected:
-    // Processing methods for each waveform type
-    virtual float processSine() {
-        return std::sin(2.0f * M_PI * phase);
+    /**
+     * Compute the raw waveform value for a given phase.
+     * 
+     * @param t The phase (0.0 - 1.0)
+     * @param dt The phase increment per sample
+     * @return The waveform value before volume is applied
+     */
+    float renderWaveform(float t, float dt) {
+        switch (waveformType) {
+            case WaveformType::Sine:
+                return processSine(t, dt);
+            case WaveformType::Square:
+                return processSquare(t, dt);
+            case WaveformType::Triangle:
+                return processTriangle(t, dt);
+            case WaveformType::Sawtooth:
+                return processSawtooth(t, dt);
+            case WaveformType::Noise:
+                return processNoise(t, dt);
+            case WaveformType::Pulse:
+                return processPulse(t, dt);
+            case WaveformType::Wavetable:
+                return processWavetable(t, dt);
+        }
+        return 0.0f;
+    }
+    
+    /**
+     * Run a block with the given per-sample waveform function.
+     * 
+     * The function is a template argument, so it is inlined into the loop.
+     * The gain ramps from rampVolume to volume across the block.
+     * 
+     * @param out The output buffer
+     * @param numSamples The number of samples to process
+     * @param t The phase (0.0 - 1.0), advanced in place
+     * @param dt The phase increment per sample
+     * @param waveform Callable returning the waveform value for (t, dt)
+     */
+    template <bool Accumulate, typename WaveformFn>
+    void runKernel(float* out, int numSamples, float& t, float dt, WaveformFn waveform) const {
+        float gain = rampVolume;
+        const float gainStep = numSamples > 0 ? (volume - rampVolume) / static_cast<float>(numSamples) : 0.0f;
+        float ph = t;
+        
+        for (int i = 0; i < numSamples; ++i) {
+            gain += gainStep;
+            float sample = waveform(ph, dt) * gain;
+            if constexpr (Accumulate) {
+                out[i] += sample;
+            } else {
+                out[i] = sample;
+            }
+            
+            ph += dt;
+            if (ph >= 1.0f) {
+                ph -= 1.0f;
+            }
+        }
+        
+        t = ph;
+    }
+    
+    /**
+     * Render kernel specialized for one waveform at compile time.
+     */
+    template <WaveformType Type, bool Accumulate>
+    void renderKernel(float* out, int numSamples, float& t, float dt, uint32_t& noise) const {
+        runKernel<Accumulate>(out, numSamples, t, dt, [this, &noise](float ph, float inc) {
+            if constexpr (Type == WaveformType::Square) {
+                return squareSample(ph, inc);
+            } else if constexpr (Type == WaveformType::Triangle) {
+                return triangleSample(ph);
+            } else if constexpr (Type == WaveformType::Sawtooth) {
+                return sawtoothSample(ph, inc);
+            } else if constexpr (Type == WaveformType::Noise) {
+                return noiseSample(noise);
+            } else if constexpr (Type == WaveformType::Pulse) {
+                return pulseSample(ph, inc);
+            } else {
+                // Sine, and the base-class fallback for Wavetable
+                return sineSample(ph);
+            }
+        });
+    }
+    
+    /**
+     * Pick the kernel for the current waveform once per block.
+     */
+    template <bool Accumulate>
+    void renderBlock(float* out, int numSamples, float& t, float dt, uint32_t& noise) const {
+        switch (waveformType) {
+            case WaveformType::Square:
+                renderKernel<WaveformType::Square, Accumulate>(out, numSamples, t, dt, noise);
+                break;
+            case WaveformType::Triangle:
+                renderKernel<WaveformType::Triangle, Accumulate>(out, numSamples, t, dt, noise);
+                break;
+            case WaveformType::Sawtooth:
+                renderKernel<WaveformType::Sawtooth, Accumulate>(out, numSamples, t, dt, noise);
+                break;
+            case WaveformType::Noise:
+                renderKernel<WaveformType::Noise, Accumulate>(out, numSamples, t, dt, noise);
+                break;
+            case WaveformType::Pulse:
+                renderKernel<WaveformType::Pulse, Accumulate>(out, numSamples, t, dt, noise);
+                break;
+            case WaveformType::Sine:
+            case WaveformType::Wavetable:
+            default:
+                renderKernel<WaveformType::Sine, Accumulate>(out, numSamples, t, dt, noise);
+                break;
+        }
     }
     
-    virtual float processSquare() {
+    // Waveform math shared by the per-sample and block paths
+    static float sineSample(float t) {
+        return std::sin(2.0f * M_PI * t);
+    }
+    
+    static float squareSample(float t, float dt) {
         // Anti-aliased square using PolyBLEP
-        float value = (phase < 0.5f) ? 1.0f : -1.0f;
-        return value - polyBLEP(phase) + polyBLEP(fmod(phase + 0.5f, 1.0f));
+        float value = (t < 0.5f) ? 1.0f : -1.0f;
+        return value - polyBLEP(t, dt) + polyBLEP(fmod(t + 0.5f, 1.0f), dt);
     }
     
-    virtual float processTriangle() {
+    static float triangleSample(float t) {
         // Generate triangle from modified sawtooth waves
-        float saw1 = 2.0f * (phase - floor(phase + 0.5f));
+        float saw1 = 2.0f * (t - floor(t + 0.5f));
         return 2.0f * (std::abs(saw1) - 0.5f);
     }
     
-    virtual float processSawtooth() {
+    static float sawtoothSample(float t, float dt) {
         // Anti-aliased sawtooth using PolyBLEP
-        float value = 2.0f * phase - 1.0f;
-        return value - polyBLEP(phase);
+        float value = 2.0f * t - 1.0f;
+        return value - polyBLEP(t, dt);
     }
     
-    virtual float processNoise() {
-        // White noise generator
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-        return dist(gen);
+    // White noise from a caller-owned xorshift state, so every voice has
+    // its own stream whichever thread renders it
+    static float noiseSample(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(static_cast<int32_t>(state)) * (1.0f / 2147483648.0f);
     }
     
-    virtual float processPulse() {
+    float pulseSample(float t, float dt) const {
         // Anti-aliased pulse wave using PolyBLEP
-        float value = (phase < pulseWidth) ? 1.0f : -1.0f;
-        return value - polyBLEP(phase) + polyBLEP(fmod(phase + (1.0f - pulseWidth), 1.0f));
+        float value = (t < pulseWidth) ? 1.0f : -1.0f;
+        return value - polyBLEP(t, dt) + polyBLEP(fmod(t + (1.0f - pulseWidth), 1.0f), dt);
+    }
+    
+    // Processing methods for each waveform type
+    virtual float processSine(float t, float /*dt*/) {
+        return sineSample(t);
+    }
+    
+    virtual float processSquare(float t, float dt) {
+        return squareSample(t, dt);
+    }
+    
+    virtual float processTriangle(float t, float /*dt*/) {
+        return triangleSample(t);
+    }
+    
+    virtual float processSawtooth(float t, float dt) {
+        return sawtoothSample(t, dt);
+    }
+    
+    virtual float processNoise(float /*t*/, float /*dt*/) {
+        return noiseSample(noiseState);
+    }
+    
+    virtual float processPulse(float t, float dt) {
+        return pulseSample(t, dt);
     }
     
-    virtual float processWavetable() {
+    virtual float processWavetable(float t, float dt) {
         // Default wavetable implementation (can be overridden)
-        return processSine(); // Fallback to sine
+        return processSine(t, dt); // Fallback to sine
     }
     
     // PolyBLEP implementation for anti-aliasing
-    float polyBLEP(float t) {
-        float dt = phaseIncrement;
-        
+    static float polyBLEP(float t, float dt) {
         // t = 0 to 1
         if (t < dt) {
             t /= dt;
@@ -241,18 +474,22 @@ protected:
         
         // Calculate phase increment per sample
         phaseIncrement = detuneFreq / static_cast<float>(sampleRate);
+        incrementPerHz = detuneMultiplier / static_cast<float>(sampleRate);
     }
     
     int sampleRate;
     float frequency;
     float phase;
     float phaseIncrement;
+    float incrementPerHz;
     float volume;
+    float rampVolume; // Volume at the start of the block, see settleVolume()
     float detune;
     float pan;
     float pulseWidth;
     WaveformType waveformType;
     float lastOutput;
+    uint32_t noiseState; // Noise generator for process() and processBlock()
 };
 
 #endif // OSCILLATOR_H
\ No newline at end of file
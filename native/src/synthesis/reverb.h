@@ -2,8 +2,10 @@
 #define REVERB_H
 
 #include "delay.h"
+#include "denormals.h"
 #include <memory>
 #include <array>
+#include <algorithm>
 
 /**
  * A simple reverb effect using a feedback delay network.
@@ -38,6 +40,8 @@ public:
      * @return The processed output sample
      */
     float process(float input) {
+        applyPendingParameters();
+        
         // Apply input diffusion by spreading the signal across all delay lines
         for (int i = 0; i < 8; ++i) {
             diffusionBuffer[i] = input * 0.125f; // Distribute energy evenly
@@ -79,6 +83,47 @@ public:
         return input * (1.0f - mix) + wetOutput * mix;
     }
     
+    /**
+     * Process a block of samples in place.
+     * 
+     * Produces the same output as calling process() per sample. The
+     * matrix result in process() is replaced by the next input diffusion
+     * before any delay line reads it, so the lines are independent and
+     * each one can run a whole block at a time.
+     * 
+     * @param samples The samples to process
+     * @param numSamples The number of samples to process
+     */
+    void processBlock(float* samples, int numSamples) {
+        applyPendingParameters();
+        
+        for (int offset = 0; offset < numSamples; offset += kBlockSize) {
+            const int n = std::min(kBlockSize, numSamples - offset);
+            float* block = samples + offset;
+            
+            for (int k = 0; k < n; ++k) {
+                wetBlock[k] = 0.0f;
+            }
+            
+            // Run each delay line over the block and sum the taps
+            for (int i = 0; i < 8; ++i) {
+                for (int k = 0; k < n; ++k) {
+                    lineBlock[k] = block[k] * 0.125f; // Distribute energy evenly
+                }
+                delays[i]->processBlock(lineBlock, n);
+                for (int k = 0; k < n; ++k) {
+                    wetBlock[k] += lineBlock[k] * 0.125f;
+                }
+            }
+            
+            // Damping filter and dry/wet mix
+            for (int k = 0; k < n; ++k) {
+                float wetOutput = lpFilter(wetBlock[k]);
+                block[k] = block[k] * (1.0f - mix) + wetOutput * mix;
+            }
+        }
+    }
+    
     /**
      * Set the sample rate.
      * 
@@ -91,6 +136,7 @@ public:
                 delay->setSampleRate(sr);
             }
         }
+        parametersDirty = true;
     }
     
     /**
@@ -100,7 +146,7 @@ public:
      */
     void setRoomSize(float size) {
         roomSize = std::clamp(size, 0.1f, 0.9f);
-        updateParameters();
+        parametersDirty = true; // Recomputed at the next block
     }
     
     /**
@@ -110,7 +156,7 @@ public:
      */
     void setDamping(float damp) {
         damping = std::clamp(damp, 0.0f, 1.0f);
-        updateParameters();
+        parametersDirty = true; // Recomputed at the next block
     }
     
     /**
@@ -122,6 +168,15 @@ public:
         mix = std::clamp(m, 0.0f, 1.0f);
     }
     
+    /**
+     * Get the wet/dry mix.
+     * 
+     * @return The mix amount (0.0 = dry, 1.0 = wet)
+     */
+    float getMix() const {
+        return mix;
+    }
+    
     /**
      * Clear the reverb state.
      */
@@ -141,6 +196,17 @@ public:
     }
     
 private:
+    /**
+     * Recompute the feedback matrix and damping coefficient if a setter
+     * changed them since the last block.
+     */
+    void applyPendingParameters() {
+        if (parametersDirty) {
+            updateParameters();
+            parametersDirty = false;
+        }
+    }
+    
     /**
      * Update internal parameters based on room size and damping.
      */
@@ -168,7 +234,7 @@ private:
      * @return The filtered output sample
      */
     float lpFilter(float input) {
-        lpFilterState = (lpFilterState * lpCoeff) + (input * (1.0f - lpCoeff));
+        lpFilterState = flushDenormal((lpFilterState * lpCoeff) + (input * (1.0f - lpCoeff)));
         return lpFilterState;
     }
     
@@ -180,6 +246,11 @@ private:
     // Delay network
     std::array<std::unique_ptr<Delay>, 8> delays;
     
+    // Scratch buffers for block processing
+    static constexpr int kBlockSize = 256;
+    float lineBlock[kBlockSize] = {0.0f};
+    float wetBlock[kBlockSize] = {0.0f};
+    
     // Buffers for the feedback delay network
     float diffusionBuffer[8] = {0.0f};
     float feedbackBuffer[8] = {0.0f};
@@ -190,6 +261,7 @@ private:
     // Low-pass filter for damping
     float lpCoeff = 0.0f;
     float lpFilterState = 0.0f;
+    bool parametersDirty = false;
 };
 
 #endif // REVERB_H
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+/**
+ * Minimal portable float vector used by the multi-voice DSP kernels.
+ *
+ * Picks AVX2 (8 lanes), SSE2 or NEON (4 lanes) from the compiler's target
+ * flags, and falls back to a plain 4-lane struct elsewhere. Define
+ * SYNTH_NO_SIMD to force the plain fallback.
+ */
+
+#if !defined(SYNTH_NO_SIMD) && defined(__AVX2__)
+#define SYNTH_SIMD_AVX2 1
+#include <immintrin.h>
+#elif !defined(SYNTH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SYNTH_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif !defined(SYNTH_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define SYNTH_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define SYNTH_SIMD_SCALAR 1
+#endif
+
+namespace simd {
+
+#if defined(SYNTH_SIMD_AVX2)
+
+constexpr int kLanes = 8;
+constexpr const char* kName = "avx2";
+
+struct Vec { __m256 v; };
+struct Mask { __m256 m; };
+
+inline Vec load(const float* p) { return {_mm256_loadu_ps(p)}; }
+inline void store(float* p, Vec a) { _mm256_storeu_ps(p, a.v); }
+inline Vec set1(float x) { return {_mm256_set1_ps(x)}; }
+inline Vec operator+(Vec a, Vec b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline Vec max(Vec a, Vec b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline Vec abs(Vec a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+inline Mask operator<(Vec a, Vec b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+inline Mask operator>(Vec a, Vec b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+inline Mask operator>=(Vec a, Vec b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+inline Vec select(Mask m, Vec a, Vec b) { return {_mm256_blendv_ps(b.v, a.v, m.m)}; }
+
+#elif defined(SYNTH_SIMD_SSE2)
+
+constexpr int kLanes = 4;
+constexpr const char* kName = "sse2";
+
+struct Vec { __m128 v; };
+struct Mask { __m128 m; };
+
+inline Vec load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void store(float* p, Vec a) { _mm_storeu_ps(p, a.v); }
+inline Vec set1(float x) { return {_mm_set1_ps(x)}; }
+inline Vec operator+(Vec a, Vec b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {_mm_div_ps(a.v, b.v)}; }
+inline Vec max(Vec a, Vec b) { return {_mm_max_ps(a.v, b.v)}; }
+inline Vec abs(Vec a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+inline Mask operator<(Vec a, Vec b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+inline Mask operator>(Vec a, Vec b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+inline Mask operator>=(Vec a, Vec b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+inline Vec select(Mask m, Vec a, Vec b) { return {_mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v))}; }
+
+#elif defined(SYNTH_SIMD_NEON)
+
+constexpr int kLanes = 4;
+constexpr const char* kName = "neon";
+
+struct Vec { float32x4_t v; };
+struct Mask { uint32x4_t m; };
+
+inline Vec load(const float* p) { return {vld1q_f32(p)}; }
+inline void store(float* p, Vec a) { vst1q_f32(p, a.v); }
+inline Vec set1(float x) { return {vdupq_n_f32(x)}; }
+inline Vec operator+(Vec a, Vec b) { return {vaddq_f32(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {vsubq_f32(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {vmulq_f32(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) {
+#if defined(__aarch64__)
+    return {vdivq_f32(a.v, b.v)};
+#else
+    // ARMv7 has no vector divide: reciprocal estimate plus two Newton steps
+    float32x4_t r = vrecpeq_f32(b.v);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    return {vmulq_f32(a.v, r)};
+#endif
+}
+inline Vec max(Vec a, Vec b) { return {vmaxq_f32(a.v, b.v)}; }
+inline Vec abs(Vec a) { return {vabsq_f32(a.v)}; }
+inline Mask operator<(Vec a, Vec b) { return {vcltq_f32(a.v, b.v)}; }
+inline Mask operator>(Vec a, Vec b) { return {vcgtq_f32(a.v, b.v)}; }
+inline Mask operator>=(Vec a, Vec b) { return {vcgeq_f32(a.v, b.v)}; }
+inline Vec select(Mask m, Vec a, Vec b) { return {vbslq_f32(m.m, a.v, b.v)}; }
+
+#else
+
+constexpr int kLanes = 4;
+constexpr const char* kName = "scalar";
+
+struct Vec { float v[kLanes]; };
+struct Mask { bool m[kLanes]; };
+
+inline Vec load(const float* p) { Vec r; for (int i = 0; i < kLanes; ++i) r.v[i] = p[i]; return r; }
+inline void store(float* p, Vec a) { for (int i = 0; i < kLanes; ++i) p[i] = a.v[i]; }
+inline Vec set1(float x) { Vec r; for (int i = 0; i < kLanes; ++i) r.v[i] = x; return r; }
+inline Vec operator+(Vec a, Vec b) { for (int i = 0; i < kLanes; ++i) a.v[i] += b.v[i]; return a; }
+inline Vec operator-(Vec a, Vec b) { for (int i = 0; i < kLanes; ++i) a.v[i] -= b.v[i]; return a; }
+inline Vec operator*(Vec a, Vec b) { for (int i = 0; i < kLanes; ++i) a.v[i] *= b.v[i]; return a; }
+inline Vec operator/(Vec a, Vec b) { for (int i = 0; i < kLanes; ++i) a.v[i] /= b.v[i]; return a; }
+inline Vec max(Vec a, Vec b) { for (int i = 0; i < kLanes; ++i) a.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return a; }
+inline Vec abs(Vec a) { for (int i = 0; i < kLanes; ++i) a.v[i] = a.v[i] < 0.0f ? -a.v[i] : a.v[i]; return a; }
+inline Mask operator<(Vec a, Vec b) { Mask r; for (int i = 0; i < kLanes; ++i) r.m[i] = a.v[i] < b.v[i]; return r; }
+inline Mask operator>(Vec a, Vec b) { Mask r; for (int i = 0; i < kLanes; ++i) r.m[i] = a.v[i] > b.v[i]; return r; }
+inline Mask operator>=(Vec a, Vec b) { Mask r; for (int i = 0; i < kLanes; ++i) r.m[i] = a.v[i] >= b.v[i]; return r; }
+inline Vec select(Mask m, Vec a, Vec b) { for (int i = 0; i < kLanes; ++i) a.v[i] = m.m[i] ? a.v[i] : b.v[i]; return a; }
+
+#endif
+
+} // namespace simd
+
+#endif // SIMD_H
@@ -0,0 +1,78 @@
+#ifndef SMOOTHED_VALUE_H
+#define SMOOTHED_VALUE_H
+
+/**
+ * A value that ramps linearly to its target over a fixed number of samples.
+ *
+ * Meant to be advanced at control rate: the owner steps it once per
+ * control block and pushes the result into the module, so expensive
+ * coefficient updates happen once per block instead of per sample and
+ * parameter jumps no longer produce zipper noise.
+ */
+class SmoothedValue {
+public:
+    /**
+     * Jump to a value immediately, cancelling any ramp.
+     *
+     * @param value The new current and target value
+     */
+    void reset(float value) {
+        current = value;
+        target = value;
+        step = 0.0f;
+        remaining = 0;
+    }
+
+    /**
+     * Start a ramp from the current value to a new target.
+     *
+     * @param value The target value
+     * @param rampSamples The ramp length in samples; 0 or less jumps immediately
+     */
+    void setTarget(float value, int rampSamples) {
+        target = value;
+        if (rampSamples <= 0 || value == current) {
+            reset(value);
+            return;
+        }
+        step = (target - current) / static_cast<float>(rampSamples);
+        remaining = rampSamples;
+    }
+
+    /**
+     * Advance the ramp.
+     *
+     * @param numSamples The number of samples that elapsed
+     * @return The value after numSamples samples
+     */
+    float advance(int numSamples) {
+        if (remaining <= numSamples) {
+            current = target;
+            remaining = 0;
+        } else {
+            current += step * static_cast<float>(numSamples);
+            remaining -= numSamples;
+        }
+        return current;
+    }
+
+    bool isSmoothing() const {
+        return remaining > 0;
+    }
+
+    float getCurrent() const {
+        return current;
+    }
+
+    float getTarget() const {
+        return target;
+    }
+
+private:
+    float current = 0.0f;
+    float target = 0.0f;
+    float step = 0.0f;
+    int remaining = 0;
+};
+
+#endif // SMOOTHED_VALUE_H
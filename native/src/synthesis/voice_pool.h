@@ -0,0 +1,510 @@
+#ifndef VOICE_POOL_H
+#define VOICE_POOL_H
+
+#include "envelope.h"
+#include "oscillator.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Preallocated pool of synthesizer voices.
+ *
+ * Every voice owns its oscillator phases, noise generator, envelope,
+ * filter and velocity state. The state is laid out as structure-of-arrays indexed by voice,
+ * so the render loop walks contiguous memory and starting a note never
+ * allocates. The shared Oscillator, Envelope and Filter modules only
+ * supply settings and coefficients.
+ *
+ * Voices are linked into intrusive lists (free, active in start order,
+ * and one list per MIDI note), so note-on and note-off never scan the
+ * whole pool, even when a sequencer floods a block with events.
+ */
+class VoicePool {
+public:
+    static constexpr int kMaxVoices = 64;
+    static constexpr int kMaxOscillators = 4;
+    static constexpr int kDefaultVoices = 16;
+    static constexpr int kNumNotes = 128;
+
+    /**
+     * What to do when a note starts and every voice is busy.
+     */
+    enum class StealPolicy {
+        SameNote,   // Retrigger the voice already playing the note, else steal the oldest
+        Oldest,     // Steal the voice that was started first
+        Quietest,   // Steal the voice with the lowest envelope level
+        None        // Never steal; drop the new note
+    };
+
+    VoicePool() : voiceLimit(kDefaultVoices), stealPolicy(StealPolicy::SameNote),
+                  noteCounter(0), stealCount(0), dropCount(0) {
+        reset();
+        seedNoise(0);
+    }
+
+    ~VoicePool() = default;
+
+    /**
+     * Set the number of voices that may sound at once.
+     *
+     * @param count The voice count (1 - kMaxVoices)
+     */
+    void setVoiceLimit(int count) {
+        voiceLimit = std::clamp(count, 1, kMaxVoices);
+
+        // Voices above the new limit are silenced immediately
+        for (int v = voiceLimit; v < kMaxVoices; ++v) {
+            if (isActive(v)) {
+                unlinkActive(v);
+                unlinkNote(v);
+            }
+            clearVoice(v);
+        }
+        rebuildFreeList();
+    }
+
+    /**
+     * Get the number of voices that may sound at once.
+     *
+     * @return The voice count
+     */
+    int getVoiceLimit() const {
+        return voiceLimit;
+    }
+
+    /**
+     * Set the voice stealing policy.
+     *
+     * @param policy The policy as integer (cast from StealPolicy enum)
+     */
+    void setStealPolicy(int policy) {
+        stealPolicy = static_cast<StealPolicy>(std::clamp(policy, 0, static_cast<int>(StealPolicy::None)));
+    }
+
+    /**
+     * Get the voice stealing policy.
+     *
+     * @return The current policy
+     */
+    StealPolicy getStealPolicy() const {
+        return stealPolicy;
+    }
+
+    /**
+     * Start a voice for a note in constant time.
+     *
+     * With the SameNote policy a voice already playing the note is
+     * retriggered. Otherwise a free voice is used, and when every voice
+     * is busy one is stolen according to the policy.
+     *
+     * @param noteNumber The MIDI note number (0-127)
+     * @param freq The note frequency in Hz
+     * @param vel The note velocity (0.0 - 1.0)
+     * @return The index of the voice that plays the note, or -1 if dropped
+     */
+    int noteOn(int noteNumber, float freq, float vel) {
+        if (noteNumber < 0 || noteNumber >= kNumNotes) {
+            return -1;
+        }
+
+        int voice = -1;
+        if (stealPolicy == StealPolicy::SameNote) {
+            voice = noteHead[noteNumber];
+        }
+        if (voice < 0) {
+            voice = popFreeVoice();
+        }
+        if (voice < 0) {
+            voice = findVoiceToSteal();
+            if (voice < 0) {
+                dropCount.fetch_add(1, std::memory_order_relaxed);
+                return -1;
+            }
+            stealCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        startVoice(voice, noteNumber, freq, vel);
+        return voice;
+    }
+
+    /**
+     * Release every held voice playing a note.
+     *
+     * Only the voices linked to this note are visited.
+     *
+     * @param noteNumber The MIDI note number (0-127)
+     * @return True if at least one voice was released
+     */
+    bool noteOff(int noteNumber) {
+        if (noteNumber < 0 || noteNumber >= kNumNotes) {
+            return false;
+        }
+
+        bool released = false;
+        for (int v = noteHead[noteNumber]; v >= 0; v = noteNext[v]) {
+            if (isHeld(v)) {
+                releaseVoice(v);
+                released = true;
+            }
+        }
+        return released;
+    }
+
+    /**
+     * Release every held voice.
+     */
+    void allNotesOff() {
+        for (int v = activeHead; v >= 0; v = activeNext[v]) {
+            if (isHeld(v)) {
+                releaseVoice(v);
+            }
+        }
+    }
+
+    /**
+     * Restart the noise generator of every voice from a seed. Each voice
+     * gets its own stream, derived from the seed and the voice index, so
+     * the noise it renders does not depend on which thread renders it.
+     *
+     * @param seed The seed
+     */
+    void seedNoise(uint32_t seed) {
+        for (int v = 0; v < kMaxVoices; ++v) {
+            noiseState[v] = Oscillator::noiseSeed(seed, v);
+        }
+    }
+
+    /**
+     * Silence all voices and clear their state.
+     */
+    void reset() {
+        for (int v = 0; v < kMaxVoices; ++v) {
+            clearVoice(v);
+        }
+        for (int n = 0; n < kNumNotes; ++n) {
+            noteHead[n] = -1;
+        }
+        activeHead = -1;
+        activeTail = -1;
+        activeCount = 0;
+        quietCount = 0;
+        quietCursor = 0;
+        quietStamp = 0;
+        noteCounter = 0;
+        rebuildFreeList();
+    }
+
+    /**
+     * Return a voice whose envelope has finished to the free list.
+     *
+     * Called by the render loop when a voice goes idle.
+     *
+     * @param voice The voice index
+     */
+    void freeVoice(int voice) {
+        unlinkActive(voice);
+        unlinkNote(voice);
+        note[voice] = -1;
+        pushFreeVoice(voice);
+    }
+
+    /**
+     * Rank the sounding voices by envelope level for the Quietest policy.
+     *
+     * Called once per block by the render loop, so stealing under load
+     * only pops from this ranking instead of scanning levels per event.
+     */
+    void updateQuietOrder() {
+        quietCount = 0;
+        quietCursor = 0;
+        quietStamp = noteCounter;
+        if (stealPolicy != StealPolicy::Quietest) {
+            return;
+        }
+
+        for (int v = activeHead; v >= 0; v = activeNext[v]) {
+            quietOrder[quietCount++] = v;
+        }
+        std::sort(quietOrder, quietOrder + quietCount, [this](int a, int b) {
+            return envLevel[a] < envLevel[b];
+        });
+    }
+
+    /**
+     * Get the first voice in the active list (oldest first).
+     *
+     * @return The voice index, or -1 if no voice is sounding
+     */
+    int firstActive() const {
+        return activeHead;
+    }
+
+    /**
+     * Get the voice after another one in the active list.
+     *
+     * @param voice The voice index
+     * @return The next voice index, or -1 at the end of the list
+     */
+    int nextActive(int voice) const {
+        return activeNext[voice];
+    }
+
+    /**
+     * Check if a voice is sounding (including its release tail).
+     *
+     * @param voice The voice index
+     * @return True if the voice is active
+     */
+    bool isActive(int voice) const {
+        return envState[voice] != Envelope::State::Idle;
+    }
+
+    /**
+     * Check if a voice is held, i.e. active and not yet released.
+     *
+     * @param voice The voice index
+     * @return True if the voice is held
+     */
+    bool isHeld(int voice) const {
+        return isActive(voice) && envState[voice] != Envelope::State::Release;
+    }
+
+    /**
+     * Get the number of voices in the active list.
+     *
+     * @return The active voice count
+     */
+    int getActiveCount() const {
+        return activeCount;
+    }
+
+    /**
+     * Get the number of voices stolen since the pool was created.
+     *
+     * Safe to call from any thread.
+     *
+     * @return The steal count
+     */
+    uint64_t getStealCount() const {
+        return stealCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Get the number of notes dropped because no voice could be stolen.
+     *
+     * Safe to call from any thread.
+     *
+     * @return The drop count
+     */
+    uint64_t getDropCount() const {
+        return dropCount.load(std::memory_order_relaxed);
+    }
+
+    // Structure-of-arrays voice state, indexed by voice
+    alignas(64) float phase[kMaxOscillators][kMaxVoices];
+    alignas(64) float frequency[kMaxVoices];
+    alignas(64) float velocity[kMaxVoices];
+    alignas(64) Envelope::State envState[kMaxVoices];
+    alignas(64) float envLevel[kMaxVoices];
+    alignas(64) float envTime[kMaxVoices];
+    alignas(64) float envReleaseLevel[kMaxVoices];
+    alignas(64) float filterLow[kMaxVoices];
+    alignas(64) float filterBand[kMaxVoices];
+    alignas(64) uint32_t noiseState[kMaxVoices]; // Shared by the voice's noise oscillators
+    alignas(64) int note[kMaxVoices];
+    alignas(64) uint64_t startOrder[kMaxVoices];
+
+private:
+    /**
+     * Pick a busy voice to steal according to the policy.
+     *
+     * @return The voice index, or -1 if the policy forbids stealing
+     */
+    int findVoiceToSteal() {
+        switch (stealPolicy) {
+            case StealPolicy::None:
+                return -1;
+
+            case StealPolicy::Quietest:
+                // Walk the ranking built at block start, skipping voices
+                // that were restarted or freed since then
+                while (quietCursor < quietCount) {
+                    int v = quietOrder[quietCursor++];
+                    if (isActive(v) && startOrder[v] <= quietStamp) {
+                        return v;
+                    }
+                }
+                return activeHead;
+
+            case StealPolicy::SameNote:
+            case StealPolicy::Oldest:
+            default:
+                return activeHead;
+        }
+    }
+
+    void startVoice(int voice, int noteNumber, float freq, float vel) {
+        if (!isActive(voice)) {
+            // Fresh voice: start from a known phase and an empty filter
+            for (int i = 0; i < kMaxOscillators; ++i) {
+                phase[i][voice] = 0.0f;
+            }
+            filterLow[voice] = 0.0f;
+            filterBand[voice] = 0.0f;
+        } else {
+            // Retriggered or stolen voice: keep its state to avoid a click
+            unlinkActive(voice);
+            unlinkNote(voice);
+        }
+
+        note[voice] = noteNumber;
+        frequency[voice] = freq;
+        velocity[voice] = vel;
+        startOrder[voice] = ++noteCounter;
+        linkActive(voice);
+        linkNote(voice);
+
+        // Same rules as Envelope::noteOn: keep a sounding level for legato
+        envState[voice] = Envelope::State::Attack;
+        envTime[voice] = 0.0f;
+        if (envLevel[voice] <= 0.001f) {
+            envLevel[voice] = 0.0f;
+        }
+    }
+
+    void releaseVoice(int voice) {
+        envState[voice] = Envelope::State::Release;
+        envReleaseLevel[voice] = envLevel[voice];
+        envTime[voice] = 0.0f;
+    }
+
+    void clearVoice(int voice) {
+        for (int i = 0; i < kMaxOscillators; ++i) {
+            phase[i][voice] = 0.0f;
+        }
+        frequency[voice] = 0.0f;
+        velocity[voice] = 0.0f;
+        envState[voice] = Envelope::State::Idle;
+        envLevel[voice] = 0.0f;
+        envTime[voice] = 0.0f;
+        envReleaseLevel[voice] = 0.0f;
+        filterLow[voice] = 0.0f;
+        filterBand[voice] = 0.0f;
+        note[voice] = -1;
+        startOrder[voice] = 0;
+        activeNext[voice] = activePrev[voice] = -1;
+        noteNext[voice] = notePrev[voice] = -1;
+    }
+
+    // Free list: singly linked through activeNext
+    int popFreeVoice() {
+        int voice = freeHead;
+        if (voice >= 0) {
+            freeHead = activeNext[voice];
+            activeNext[voice] = -1;
+        }
+        return voice;
+    }
+
+    void pushFreeVoice(int voice) {
+        activeNext[voice] = freeHead;
+        activePrev[voice] = -1;
+        freeHead = voice;
+    }
+
+    void rebuildFreeList() {
+        freeHead = -1;
+        for (int v = voiceLimit - 1; v >= 0; --v) {
+            if (!isActive(v)) {
+                pushFreeVoice(v);
+            }
+        }
+    }
+
+    // Active list: doubly linked in start order, oldest at the head
+    void linkActive(int voice) {
+        activePrev[voice] = activeTail;
+        activeNext[voice] = -1;
+        if (activeTail >= 0) {
+            activeNext[activeTail] = voice;
+        } else {
+            activeHead = voice;
+        }
+        activeTail = voice;
+        ++activeCount;
+    }
+
+    void unlinkActive(int voice) {
+        int prev = activePrev[voice];
+        int next = activeNext[voice];
+        if (prev >= 0) {
+            activeNext[prev] = next;
+        } else {
+            activeHead = next;
+        }
+        if (next >= 0) {
+            activePrev[next] = prev;
+        } else {
+            activeTail = prev;
+        }
+        activeNext[voice] = activePrev[voice] = -1;
+        --activeCount;
+    }
+
+    // Per-note lists: doubly linked, newest at the head
+    void linkNote(int voice) {
+        int n = note[voice];
+        notePrev[voice] = -1;
+        noteNext[voice] = noteHead[n];
+        if (noteHead[n] >= 0) {
+            notePrev[noteHead[n]] = voice;
+        }
+        noteHead[n] = voice;
+    }
+
+    void unlinkNote(int voice) {
+        int n = note[voice];
+        if (n < 0) {
+            return;
+        }
+        int prev = notePrev[voice];
+        int next = noteNext[voice];
+        if (prev >= 0) {
+            noteNext[prev] = next;
+        } else {
+            noteHead[n] = next;
+        }
+        if (next >= 0) {
+            notePrev[next] = prev;
+        }
+        noteNext[voice] = notePrev[voice] = -1;
+    }
+
+    int voiceLimit;
+    StealPolicy stealPolicy;
+    uint64_t noteCounter;
+
+    // Intrusive list links
+    int activeNext[kMaxVoices];
+    int activePrev[kMaxVoices];
+    int noteNext[kMaxVoices];
+    int notePrev[kMaxVoices];
+    int noteHead[kNumNotes];
+    int activeHead;
+    int activeTail;
+    int activeCount;
+    int freeHead;
+
+    // Quietest-first ranking, rebuilt once per block
+    int quietOrder[kMaxVoices];
+    int quietCount;
+    int quietCursor;
+    uint64_t quietStamp;
+
+    // Statistics, readable from any thread
+    std::atomic<uint64_t> stealCount;
+    std::atomic<uint64_t> dropCount;
+};
+
+#endif // VOICE_POOL_H
@@ -0,0 +1,220 @@
+#ifndef VOICE_WORKER_POOL_H
+#define VOICE_WORKER_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "denormals.h"
+#include "rt_safety.h"
+
+/**
+ * Small work-stealing thread pool for splitting voice rendering across cores.
+ *
+ * The audio thread calls run() once per block with a number of batches.
+ * Batches are split into one contiguous range per participant (the caller
+ * is participant 0); each participant claims batches from its own range
+ * and, once that is exhausted, steals from the ranges of the others.
+ * run() returns only after every batch has finished, so results can be
+ * combined in a fixed order afterwards.
+ *
+ * The caller always takes part, so a worker that wakes late only costs
+ * parallelism, never correctness. The audio thread never takes a lock:
+ * workers spin briefly after each job and then sleep on a condition
+ * variable that the audio thread signals without holding its mutex.
+ */
+class VoiceWorkerPool {
+public:
+    static constexpr int kMaxThreads = 8;
+
+    using Task = void (*)(void* context, int batch, int thread);
+
+    /**
+     * Start the worker threads.
+     *
+     * @param numThreads Total participants including the calling thread (1 - kMaxThreads)
+     */
+    explicit VoiceWorkerPool(int numThreads)
+        : threadCount(std::max(1, std::min(numThreads, kMaxThreads))) {
+        workers.reserve(threadCount - 1);
+        for (int i = 1; i < threadCount; ++i) {
+            workers.emplace_back(&VoiceWorkerPool::workerLoop, this, i);
+        }
+    }
+
+    ~VoiceWorkerPool() {
+        running.store(false);
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wakeCondition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    VoiceWorkerPool(const VoiceWorkerPool&) = delete;
+    VoiceWorkerPool& operator=(const VoiceWorkerPool&) = delete;
+
+    /**
+     * Get the number of participants including the calling thread.
+     *
+     * @return The thread count
+     */
+    int getThreadCount() const {
+        return threadCount;
+    }
+
+    /**
+     * Default participant count for this machine: one per core, capped.
+     *
+     * @return The suggested thread count
+     */
+    static int defaultThreadCount() {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        return std::max(1, std::min(cores, kMaxThreads));
+    }
+
+    /**
+     * Run a task for every batch and wait for all of them to finish.
+     * Must only be called from one thread at a time.
+     *
+     * @param numBatches Number of batches to run
+     * @param task Called as task(context, batch, thread) with thread in [0, getThreadCount())
+     * @param context Passed through to the task
+     */
+    void run(int numBatches, Task task, void* context) {
+        if (numBatches <= 0) {
+            return;
+        }
+        if (threadCount == 1 || numBatches == 1) {
+            for (int batch = 0; batch < numBatches; ++batch) {
+                task(context, batch, 0);
+            }
+            return;
+        }
+
+        // Publish the job; workers only read it after seeing jobOpen
+        jobTask = task;
+        jobContext = context;
+        for (int p = 0; p < threadCount; ++p) {
+            ranges[p].cursor.store(numBatches * p / threadCount, std::memory_order_relaxed);
+            ranges[p].end = numBatches * (p + 1) / threadCount;
+        }
+        completed.store(0, std::memory_order_relaxed);
+        generation.fetch_add(1);
+        jobOpen.store(true);
+        wakeCondition.notify_all();
+
+        runBatches(0);
+
+        // Join: wait for stolen batches, then for workers still scanning
+        while (completed.load(std::memory_order_acquire) < numBatches) {
+            std::this_thread::yield();
+        }
+        jobOpen.store(false);
+        while (busy.load() > 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Convenience overload for lambdas and other callables.
+     */
+    template <typename Function>
+    void run(int numBatches, Function& function) {
+        run(numBatches, [](void* context, int batch, int thread) {
+            (*static_cast<Function*>(context))(batch, thread);
+        }, &function);
+    }
+
+private:
+    struct alignas(64) Range {
+        std::atomic<int> cursor{0};
+        int end = 0;
+    };
+
+    int claimBatch(int participant) {
+        // Own range first, then steal from the others in turn
+        for (int i = 0; i < threadCount; ++i) {
+            Range& range = ranges[(participant + i) % threadCount];
+            if (range.cursor.load(std::memory_order_relaxed) >= range.end) {
+                continue;
+            }
+            int batch = range.cursor.fetch_add(1, std::memory_order_relaxed);
+            if (batch < range.end) {
+                return batch;
+            }
+        }
+        return -1;
+    }
+
+    void runBatches(int participant) {
+        for (int batch = claimBatch(participant); batch >= 0; batch = claimBatch(participant)) {
+            jobTask(jobContext, batch, participant);
+            completed.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void workerLoop(int participant) {
+        // Workers render voices too, so they need the audio thread's FPU mode
+        ScopedDenormalsDisabled noDenormals;
+        unsigned seenGeneration = generation.load();
+        bool justWorked = false;
+        while (running.load()) {
+            if (generation.load() == seenGeneration) {
+                // Spin for a short while after a job so back-to-back
+                // callbacks find this worker awake
+                for (int spin = 0; justWorked && spin < kSpinCount; ++spin) {
+                    if (generation.load() != seenGeneration || !running.load(std::memory_order_relaxed)) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+                if (generation.load() == seenGeneration) {
+                    std::unique_lock<std::mutex> lock(wakeMutex);
+                    // Bounded wait: the audio thread notifies without the mutex,
+                    // so a wakeup can slip past between the check and the wait
+                    wakeCondition.wait_for(lock, std::chrono::milliseconds(1), [this, seenGeneration] {
+                        return !running.load() || generation.load() != seenGeneration;
+                    });
+                }
+                if (generation.load() == seenGeneration) {
+                    justWorked = false;
+                    continue;
+                }
+            }
+            seenGeneration = generation.load();
+
+            busy.fetch_add(1);
+            if (jobOpen.load()) {
+                SYNTH_RT_AUDIO_THREAD("voiceWorker");
+                runBatches(participant);
+            }
+            busy.fetch_sub(1);
+            justWorked = true;
+        }
+    }
+
+    static constexpr int kSpinCount = 2000;
+
+    const int threadCount;
+    std::vector<std::thread> workers;
+    std::atomic<bool> running{true};
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<unsigned> generation{0};
+    std::atomic<bool> jobOpen{false};
+    std::atomic<int> busy{0};
+
+    Task jobTask = nullptr;
+    void* jobContext = nullptr;
+    Range ranges[kMaxThreads];
+    alignas(64) std::atomic<int> completed{0};
+};
+
+#endif // VOICE_WORKER_POOL_H
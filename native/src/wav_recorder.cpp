@@ -0,0 +1,240 @@
+#include "wav_recorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// RIFF header with room for an RF64 ds64 chunk (a JUNK chunk until needed),
+// a WAVE_FORMAT_IEEE_FLOAT fmt chunk and a fact chunk
+constexpr long kHeaderSize = 94;
+constexpr uint64_t kMaxRiffData = 0xFFFFFFFFull - (kHeaderSize - 8);
+
+void put16(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put32(uint8_t* p, uint32_t v) {
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+void put64(uint8_t* p, uint64_t v) {
+    put32(p, static_cast<uint32_t>(v));
+    put32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+void putTag(uint8_t* p, const char* tag) {
+    std::memcpy(p, tag, 4);
+}
+
+// Reserve disk space so the writer does not extend the file on every write
+void preallocate(std::FILE* file, uint64_t bytes) {
+#if defined(__linux__) || defined(__ANDROID__)
+    posix_fallocate(fileno(file), 0, static_cast<off_t>(bytes));
+#elif defined(__APPLE__)
+    fstore_t store = {F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, static_cast<off_t>(bytes), 0};
+    if (fcntl(fileno(file), F_PREALLOCATE, &store) == -1) {
+        store.fst_flags = F_ALLOCATEALL;
+        fcntl(fileno(file), F_PREALLOCATE, &store);
+    }
+#elif defined(_WIN32)
+    _chsize_s(_fileno(file), static_cast<__int64>(bytes));
+#else
+    (void)file;
+    (void)bytes;
+#endif
+}
+
+// Cut off whatever preallocated space was not used
+void truncateFile(std::FILE* file, uint64_t bytes) {
+    std::fflush(file);
+#if defined(_WIN32)
+    _chsize_s(_fileno(file), static_cast<__int64>(bytes));
+#else
+    if (ftruncate(fileno(file), static_cast<off_t>(bytes)) != 0) {
+        std::cerr << "WavRecorder: failed to truncate file" << std::endl;
+    }
+#endif
+}
+
+} // namespace
+
+WavRecorder::~WavRecorder() {
+    stop();
+}
+
+bool WavRecorder::start(const std::string& path, int sampleRate, int numChannels, int preallocateSeconds) {
+    if (writer.joinable() || sampleRate <= 0 || numChannels <= 0) {
+        return false; // Already recording, or invalid format
+    }
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "WavRecorder: cannot open " << path << std::endl;
+        return false;
+    }
+    // Writes are already large; skip the stdio copy
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    rate = sampleRate;
+    channels = numChannels;
+    dataBytes = 0;
+    writeHeader(0);
+    if (preallocateSeconds > 0) {
+        preallocate(file, kHeaderSize + static_cast<uint64_t>(preallocateSeconds) * rate * channels * sizeof(float));
+    }
+    std::fseek(file, kHeaderSize, SEEK_SET);
+
+    try {
+        // Allocated here, never on the audio thread
+        ring.assign(kRingSize, 0.0f);
+        writePos.store(0, std::memory_order_relaxed);
+        readPos.store(0, std::memory_order_relaxed);
+        recordedFrames.store(0, std::memory_order_relaxed);
+        droppedFrames.store(0, std::memory_order_relaxed);
+        stopRequested.store(false);
+        writer = std::thread(&WavRecorder::run, this);
+    } catch (const std::exception& e) {
+        std::cerr << "WavRecorder: " << e.what() << std::endl;
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    recording.store(true);
+    return true;
+}
+
+void WavRecorder::stop() {
+    if (!writer.joinable()) {
+        return;
+    }
+
+    // Once the audio thread is out of write() it will not see the ring again
+    recording.store(false);
+    while (audioBusy.load()) {
+        std::this_thread::yield();
+    }
+
+    stopRequested.store(true, std::memory_order_release);
+    writer.join();
+}
+
+void WavRecorder::write(const float* samples, int numFrames, int numChannels) {
+    audioBusy.store(true);
+    if (!recording.load() || numChannels != channels) {
+        audioBusy.store(false, std::memory_order_release);
+        return;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(numFrames * numChannels);
+    const uint32_t w = writePos.load(std::memory_order_relaxed);
+    const uint32_t r = readPos.load(std::memory_order_acquire);
+    if (kRingSize - (w - r) < count) {
+        // The writer fell behind, e.g. the disk stalled; never wait for it
+        droppedFrames.store(droppedFrames.load(std::memory_order_relaxed) + numFrames,
+                            std::memory_order_relaxed);
+    } else {
+        const uint32_t start = w & kRingMask;
+        const uint32_t first = std::min(count, kRingSize - start);
+        std::copy(samples, samples + first, ring.data() + start);
+        std::copy(samples + first, samples + count, ring.data());
+        writePos.store(w + count, std::memory_order_release);
+    }
+    audioBusy.store(false, std::memory_order_release);
+}
+
+void WavRecorder::run() {
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        if (!drain(false)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    // The audio thread has stopped writing; flush the rest and finalize
+    drain(true);
+    writeHeader(dataBytes);
+    truncateFile(file, kHeaderSize + dataBytes);
+    std::fclose(file);
+    file = nullptr;
+}
+
+bool WavRecorder::drain(bool flush) {
+    bool wrote = false;
+    uint32_t r = readPos.load(std::memory_order_relaxed);
+    uint32_t available = writePos.load(std::memory_order_acquire) - r;
+
+    // Write whole chunks while recording, everything when flushing
+    while (available >= kWriteChunk || (flush && available > 0)) {
+        const uint32_t count = std::min(available, kWriteChunk);
+        const uint32_t start = r & kRingMask;
+        const uint32_t first = std::min(count, kRingSize - start);
+        size_t written = std::fwrite(ring.data() + start, sizeof(float), first, file);
+        if (first < count) {
+            written += std::fwrite(ring.data(), sizeof(float), count - first, file);
+        }
+
+        r += count;
+        readPos.store(r, std::memory_order_release);
+        available -= count;
+        dataBytes += written * sizeof(float);
+        recordedFrames.store(dataBytes / (sizeof(float) * channels), std::memory_order_relaxed);
+        if (written < count) {
+            // Disk full or failing; count the loss and keep the ring moving
+            droppedFrames.store(droppedFrames.load(std::memory_order_relaxed) + (count - written) / channels,
+                                std::memory_order_relaxed);
+        }
+        wrote = true;
+    }
+    return wrote;
+}
+
+void WavRecorder::writeHeader(uint64_t bytes) {
+    const bool rf64 = bytes > kMaxRiffData;
+    const uint64_t frames = bytes / (sizeof(float) * channels);
+    const uint32_t blockAlign = static_cast<uint32_t>(channels * sizeof(float));
+
+    uint8_t header[kHeaderSize] = {};
+    putTag(header, rf64 ? "RF64" : "RIFF");
+    put32(header + 4, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(bytes + kHeaderSize - 8));
+    putTag(header + 8, "WAVE");
+
+    // ds64 carries the 64-bit sizes in RF64 files; plain WAV readers skip JUNK
+    putTag(header + 12, rf64 ? "ds64" : "JUNK");
+    put32(header + 16, 28);
+    if (rf64) {
+        put64(header + 20, bytes + kHeaderSize - 8);
+        put64(header + 28, bytes);
+        put64(header + 36, frames);
+    }
+
+    putTag(header + 48, "fmt ");
+    put32(header + 52, 18);
+    put16(header + 56, 3); // WAVE_FORMAT_IEEE_FLOAT
+    put16(header + 58, static_cast<uint32_t>(channels));
+    put32(header + 60, static_cast<uint32_t>(rate));
+    put32(header + 64, static_cast<uint32_t>(rate) * blockAlign);
+    put16(header + 68, blockAlign);
+    put16(header + 70, 32);
+    put16(header + 72, 0);
+
+    putTag(header + 74, "fact");
+    put32(header + 78, 4);
+    put32(header + 82, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(frames));
+
+    putTag(header + 86, "data");
+    put32(header + 90, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(bytes));
+
+    std::fseek(file, 0, SEEK_SET);
+    std::fwrite(header, 1, sizeof(header), file);
+}
@@ -0,0 +1,106 @@
+#ifndef WAV_RECORDER_H
+#define WAV_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Records interleaved float audio to a WAV file without blocking the
+ * audio thread.
+ *
+ * The audio thread copies each block into a lock-free ring buffer and
+ * never touches the disk; a writer thread drains the ring in large
+ * sequential writes. If the disk stalls long enough for the ring to fill,
+ * new audio is dropped and counted rather than waited for.
+ *
+ * Files are 32-bit float WAV, preallocated up front to avoid growing the
+ * file on every write, and upgraded in place to RF64 when the data
+ * outgrows the 4 GB RIFF limit.
+ */
+class WavRecorder {
+public:
+    WavRecorder() = default;
+    ~WavRecorder();
+
+    WavRecorder(const WavRecorder&) = delete;
+    WavRecorder& operator=(const WavRecorder&) = delete;
+
+    /**
+     * Open a file and start recording. Control thread only.
+     *
+     * @param path The output file path
+     * @param sampleRate The sample rate of the recorded audio
+     * @param numChannels The number of interleaved channels
+     * @param preallocateSeconds Disk space to reserve up front, in seconds
+     * @return True on success, false if already recording or the file
+     *         cannot be created
+     */
+    bool start(const std::string& path, int sampleRate, int numChannels, int preallocateSeconds = 60);
+
+    /**
+     * Stop recording, write out everything buffered and finalize the file.
+     * Control thread only; does nothing if not recording.
+     */
+    void stop();
+
+    /**
+     * Queue a block of audio. Audio thread only; lock-free and wait-free.
+     *
+     * @param samples Interleaved samples
+     * @param numFrames The number of frames
+     * @param numChannels The channel count of the block; blocks that do
+     *                    not match the recording are ignored
+     */
+    void write(const float* samples, int numFrames, int numChannels);
+
+    bool isRecording() const {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Frames written to the file, and frames dropped because the ring
+     * buffer was full, since the last start().
+     */
+    uint64_t getRecordedFrames() const {
+        return recordedFrames.load(std::memory_order_relaxed);
+    }
+
+    uint64_t getDroppedFrames() const {
+        return droppedFrames.load(std::memory_order_relaxed);
+    }
+
+private:
+    // About 10 seconds of stereo at 48 kHz
+    static constexpr uint32_t kRingSize = 1u << 20;
+    static constexpr uint32_t kRingMask = kRingSize - 1;
+    // Samples per disk write
+    static constexpr uint32_t kWriteChunk = 1u << 16;
+
+    void run();
+    bool drain(bool flush);
+    void writeHeader(uint64_t dataBytes);
+
+    std::vector<float> ring;
+    alignas(64) std::atomic<uint32_t> writePos{0}; // Audio thread
+    alignas(64) std::atomic<uint32_t> readPos{0};  // Writer thread
+
+    alignas(64) std::atomic<bool> recording{false};
+    std::atomic<bool> audioBusy{false};
+    std::atomic<bool> stopRequested{false};
+    std::atomic<uint64_t> recordedFrames{0};
+    std::atomic<uint64_t> droppedFrames{0};
+
+    // Writer thread state
+    std::FILE* file = nullptr;
+    std::thread writer;
+    std::vector<float> chunk;
+    uint64_t dataBytes = 0;
+    int channels = 2;
+    int rate = 44100;
+};
+
+#endif // WAV_RECORDER_H
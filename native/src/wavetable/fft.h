@@ -0,0 +1,51 @@
+#pragma once
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace synth {
+
+inline bool isPowerOfTwo(size_t n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+/// In-place iterative radix-2 FFT. The size must be a power of two; the
+/// inverse is unscaled, so divide by the size afterwards. Allocation-free
+/// but not cheap: meant for building tables, not for the audio thread.
+inline void fft(std::vector<std::complex<double>>& data, bool inverse) {
+    const size_t n = data.size();
+    if (!isPowerOfTwo(n) || n < 2) return;
+
+    // Bit-reversal permutation
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j |= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    // Butterflies
+    const double sign = inverse ? 1.0 : -1.0;
+    for (size_t length = 2; length <= n; length <<= 1) {
+        const double angle = sign * 2.0 * M_PI / static_cast<double>(length);
+        const std::complex<double> step(std::cos(angle), std::sin(angle));
+        for (size_t start = 0; start < n; start += length) {
+            std::complex<double> w(1.0, 0.0);
+            for (size_t k = 0; k < length / 2; ++k) {
+                const std::complex<double> even = data[start + k];
+                const std::complex<double> odd = data[start + k + length / 2] * w;
+                data[start + k] = even + odd;
+                data[start + k + length / 2] = even - odd;
+                w *= step;
+            }
+        }
+    }
+}
+
+} // namespace synth
@@ -1,11 +1,17 @@
 #pragma once
+#include "fft.h"
 #include <vector>
 #include <string>
 #include <cmath>
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <new>
+#include <utility>
 
 namespace synth {
 
-/// A single wavetable frame/cycle
+/// A single wavetable frame/cycle, used to build tables
 struct WaveFrame {
     std::vector<float> samples;
     
@@ -14,42 +20,142 @@ struct WaveFrame {
     float getSample(float phase) const {
         if (samples.empty()) return 0.0f;
         
-        // Linear interpolation between samples
-        float indexFloat = phase * (samples.size() - 1);
-        size_t index0 = static_cast<size_t>(indexFloat);
+        // Linear interpolation between samples; the last one blends back
+        // into the first
+        float indexFloat = phase * samples.size();
+        size_t index = static_cast<size_t>(indexFloat);
+        float fraction = indexFloat - index;
+        size_t index0 = index % samples.size();
         size_t index1 = (index0 + 1) % samples.size();
-        float fraction = indexFloat - index0;
         
         return samples[index0] * (1.0f - fraction) + samples[index1] * fraction;
     }
 };
 
 /// A collection of wave frames that can be morphed between
+///
+/// Frames are copied into one 64-byte-aligned buffer, level by level: all
+/// frames of mip level 0, then all of level 1, and so on. Each frame sits
+/// between kGuardSamples wrapped samples on either side and starts on a
+/// 64-byte boundary, so neighbouring frames are neighbours in memory and
+/// interpolation can read one past the end without a modulo.
 class Wavetable {
 public:
+    static constexpr size_t kGuardSamples = 16; // One cache line of floats
+    
+    /// Reads one pair of adjacent frames at one mip level; resolve once per
+    /// block with getReader() when position and level are fixed
+    struct Reader {
+        const float* frame0;
+        const float* frame1;
+        float frameFraction;
+        float indexScale; // Frame size
+        
+        float getSample(float phase) const {
+            // Guard samples stand in for the wrap: past the last sample,
+            // index frameSize holds sample 0, so no bounds checks
+            const float indexFloat = phase * indexScale;
+            const int index0 = static_cast<int>(indexFloat);
+            const float fraction = indexFloat - index0;
+            
+            const float sample0 = frame0[index0] * (1.0f - fraction) + frame0[index0 + 1] * fraction;
+            const float sample1 = frame1[index0] * (1.0f - fraction) + frame1[index0 + 1] * fraction;
+            return sample0 * (1.0f - frameFraction) + sample1 * frameFraction;
+        }
+    };
+    
     Wavetable(const std::string& name = "Default") : name_(name) {}
     
-    // Add a wave frame to the table
+    // Add a wave frame to the table and build its mip levels. Frames are
+    // resampled to the size of the first one.
     void addFrame(const WaveFrame& frame) {
-        frames_.push_back(frame);
+        if (frameCount_ == 0) {
+            frameSize_ = frame.samples.size();
+            levelCount_ = isPowerOfTwo(frameSize_) && frameSize_ >= 4
+                ? 1 + static_cast<int>(std::log2(static_cast<double>(frameSize_ / 2)))
+                : 1;
+            stride_ = alignSize(frameSize_ + 2 * kGuardSamples);
+        }
+        if (frameSize_ == 0) return;
+        
+        std::vector<float> samples = frame.samples;
+        if (samples.size() != frameSize_) {
+            samples.resize(frameSize_);
+            for (size_t i = 0; i < frameSize_; ++i) {
+                samples[i] = frame.getSample(static_cast<float>(i) / frameSize_);
+            }
+        }
+        
+        if (frameCount_ == frameCapacity_) {
+            grow(std::max<size_t>(4, frameCapacity_ * 2));
+        }
+        const std::vector<std::vector<float>> levels = buildMipLevels(samples);
+        for (int level = 0; level < levelCount_; ++level) {
+            writeFrame(frameData(frameCount_, level), levels[level]);
+        }
+        ++frameCount_;
     }
     
     // Get interpolated sample from the wavetable
     float getSample(float phase, float position) const {
-        if (frames_.empty()) return 0.0f;
+        return getSample(phase, position, 0);
+    }
+    
+    // Get interpolated sample from one mip level, see getMipLevel()
+    float getSample(float phase, float position, int level) const {
+        return getReader(position, level).getSample(phase);
+    }
+    
+    /**
+     * Resolve the two frames a position falls between.
+     *
+     * @param position Table position, 0.0 - 1.0
+     * @param level Mip level, see getMipLevel()
+     * @return A reader for that position and level
+     */
+    Reader getReader(float position, int level) const {
+        if (frameCount_ == 0) {
+            static const float silence[2] = {0.0f, 0.0f};
+            return Reader{silence, silence, 0.0f, 0.0f};
+        }
         
-        // Position determines which frames to interpolate between
-        float frameIndex = position * (frames_.size() - 1);
+        // Position determines which frames to interpolate between; at the
+        // last frame the fraction is zero, so clamping frame1 is exact
+        float frameIndex = position * (frameCount_ - 1);
         size_t frame0 = static_cast<size_t>(frameIndex);
-        size_t frame1 = (frame0 + 1) % frames_.size();
+        size_t frame1 = std::min(frame0 + 1, frameCount_ - 1);
         float frameFraction = frameIndex - frame0;
         
-        // Get samples from both frames
-        float sample0 = frames_[frame0].getSample(phase);
-        float sample1 = frames_[frame1].getSample(phase);
-        
-        // Interpolate between frames
-        return sample0 * (1.0f - frameFraction) + sample1 * frameFraction;
+        level = std::clamp(level, 0, levelCount_ - 1);
+        return Reader{frameData(frame0, level), frameData(frame1, level), frameFraction,
+                      static_cast<float>(frameSize_)};
+    }
+    
+    /**
+     * Pick the mip level to play at a pitch: the one with the most
+     * harmonics that all stay below Nyquist. Call once per block.
+     *
+     * @param phaseIncrement Cycles per sample, frequency / sample rate
+     * @return The level, 0 - getMipLevelCount() - 1
+     */
+    int getMipLevel(float phaseIncrement) const {
+        // Level k keeps (size / 2) >> k harmonics; the top one must stay
+        // below half a cycle per sample: 2^k >= size * phaseIncrement
+        const float cycles = static_cast<float>(frameSize_) * std::fabs(phaseIncrement);
+        if (cycles <= 1.0f) return 0;
+        int exponent;
+        const float mantissa = std::frexp(cycles, &exponent);
+        const int level = mantissa == 0.5f ? exponent - 1 : exponent;
+        return std::min(level, levelCount_ - 1);
+    }
+    
+    int getMipLevelCount() const { return levelCount_; }
+    size_t getFrameSize() const { return frameSize_; }
+    
+    // First sample of a frame; frameSize + kGuardSamples may be read on
+    // either side
+    const float* getFrameData(size_t frame, int level) const {
+        return frameData(frame, level);
     }
     
     // Factory methods for common wavetables
@@ -122,11 +228,128 @@ public:
     }
     
     const std::string& getName() const { return name_; }
-    size_t getFrameCount() const { return frames_.size(); }
+    size_t getFrameCount() const { return frameCount_; }
     
 private:
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kAlignFloats = kAlignment / sizeof(float);
+    
+    /// Owns the 64-byte-aligned sample storage; copies are deep
+    class AlignedBuffer {
+    public:
+        AlignedBuffer() = default;
+        explicit AlignedBuffer(size_t size)
+            : data_(size > 0 ? static_cast<float*>(::operator new[](size * sizeof(float), std::align_val_t(kAlignment)))
+                             : nullptr)
+            , size_(size) {
+            std::fill(data_, data_ + size_, 0.0f);
+        }
+        AlignedBuffer(const AlignedBuffer& other) : AlignedBuffer(other.size_) {
+            std::copy(other.data_, other.data_ + size_, data_);
+        }
+        AlignedBuffer(AlignedBuffer&& other) noexcept
+            : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+        AlignedBuffer& operator=(AlignedBuffer other) noexcept {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+        ~AlignedBuffer() {
+            if (data_) ::operator delete[](data_, std::align_val_t(kAlignment));
+        }
+        
+        float* data() { return data_; }
+        const float* data() const { return data_; }
+        
+    private:
+        float* data_ = nullptr;
+        size_t size_ = 0;
+    };
+    
+    static size_t alignSize(size_t floats) {
+        return (floats + kAlignFloats - 1) / kAlignFloats * kAlignFloats;
+    }
+    
+    float* frameData(size_t frame, int level) {
+        return storage_.data() + (static_cast<size_t>(level) * frameCapacity_ + frame) * stride_ + kGuardSamples;
+    }
+    
+    const float* frameData(size_t frame, int level) const {
+        return storage_.data() + (static_cast<size_t>(level) * frameCapacity_ + frame) * stride_ + kGuardSamples;
+    }
+    
+    // Copy a frame in with its wrapped guard samples
+    void writeFrame(float* dest, const std::vector<float>& samples) {
+        std::copy(samples.begin(), samples.end(), dest);
+        for (size_t i = 0; i < kGuardSamples; ++i) {
+            dest[frameSize_ + i] = samples[i % frameSize_];
+            dest[-1 - static_cast<ptrdiff_t>(i)] = samples[frameSize_ - 1 - i % frameSize_];
+        }
+    }
+    
+    // Reallocate for more frames; each level's frames stay contiguous
+    void grow(size_t capacity) {
+        AlignedBuffer storage(static_cast<size_t>(levelCount_) * capacity * stride_);
+        for (int level = 0; level < levelCount_; ++level) {
+            for (size_t frame = 0; frame < frameCount_; ++frame) {
+                const float* source = frameData(frame, level) - kGuardSamples;
+                std::copy(source, source + stride_,
+                          storage.data() + (static_cast<size_t>(level) * capacity + frame) * stride_);
+            }
+        }
+        storage_ = std::move(storage);
+        frameCapacity_ = capacity;
+    }
+    
+    // Level 0 is the frame itself; level k keeps harmonics up to
+    // (size / 2) >> k, via FFT. Levels that would keep every harmonic the
+    // frame has are exact copies of it.
+    std::vector<std::vector<float>> buildMipLevels(const std::vector<float>& samples) const {
+        std::vector<std::vector<float>> levels(levelCount_, samples);
+        if (levelCount_ == 1) return levels;
+        
+        const size_t size = samples.size();
+        std::vector<std::complex<double>> spectrum(samples.begin(), samples.end());
+        fft(spectrum, false);
+        
+        // Highest harmonic with audible energy, relative to the strongest
+        const size_t nyquist = size / 2;
+        double peak = 0.0;
+        for (size_t bin = 1; bin <= nyquist; ++bin) {
+            peak = std::max(peak, std::abs(spectrum[bin]));
+        }
+        size_t highest = 0;
+        for (size_t bin = 1; bin <= nyquist; ++bin) {
+            if (std::abs(spectrum[bin]) > peak * 1.0e-6) {
+                highest = bin;
+            }
+        }
+        
+        std::vector<std::complex<double>> level(size);
+        for (int k = 1; k < levelCount_; ++k) {
+            const size_t limit = nyquist >> k;
+            if (limit >= highest) continue;
+            
+            // Keep DC and harmonics 1 - limit with their mirror images
+            level = spectrum;
+            for (size_t bin = limit + 1; bin < size - limit; ++bin) {
+                level[bin] = 0.0;
+            }
+            fft(level, true);
+            for (size_t i = 0; i < size; ++i) {
+                levels[k][i] = static_cast<float>(level[i].real() / static_cast<double>(size));
+            }
+        }
+        return levels;
+    }
+    
     std::string name_;
-    std::vector<WaveFrame> frames_;
+    AlignedBuffer storage_;
+    size_t frameSize_ = 0;
+    size_t stride_ = 0;         // Floats per frame including guards and padding
+    size_t frameCount_ = 0;
+    size_t frameCapacity_ = 0;
+    int levelCount_ = 1;
 };
 
 /// Wavetable oscillator class
@@ -138,6 +361,7 @@ public:
         , frequency_(440.0f)
         , sampleRate_(44100.0f)
         , tablePosition_(0.0f)
+        , mipLevel_(0)
         , currentTable_(nullptr) {
         updatePhaseIncrement();
     }
@@ -154,16 +378,21 @@ public:
     
     void setWavetable(const Wavetable* table) {
         currentTable_ = table;
+        updateMipLevel();
     }
     
     void setTablePosition(float position) {
         tablePosition_ = std::clamp(position, 0.0f, 1.0f);
     }
     
+    const Wavetable* getWavetable() const { return currentTable_; }
+    float getTablePosition() const { return tablePosition_; }
+    int getMipLevel() const { return mipLevel_; }
+    
     float process() {
         if (!currentTable_) return 0.0f;
         
-        float sample = currentTable_->getSample(phase_, tablePosition_);
+        float sample = currentTable_->getSample(phase_, tablePosition_, mipLevel_);
         
         // Update phase
         phase_ += phaseIncrement_;
@@ -181,6 +410,12 @@ public:
 private:
     void updatePhaseIncrement() {
         phaseIncrement_ = frequency_ / sampleRate_;
+        updateMipLevel();
+    }
+    
+    // The band-limited level follows the pitch, so process() pays nothing for it
+    void updateMipLevel() {
+        mipLevel_ = currentTable_ ? currentTable_->getMipLevel(phaseIncrement_) : 0;
     }
     
     float phase_;
@@ -188,6 +423,7 @@ private:
     float frequency_;
     float sampleRate_;
     float tablePosition_;
+    int mipLevel_;
     const Wavetable* currentTable_;
 };
 
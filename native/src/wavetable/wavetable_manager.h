@@ -5,7 +5,10 @@
 
 namespace synth {
 
-/// Manages a collection of wavetables and provides access to them
+/// Manages a collection of wavetables and provides access to them.
+/// Tables are immutable once added; the built-in ones are built once per
+/// process and shared by every manager, since their mip levels take a
+/// batch of FFTs to compute.
 class WavetableManager {
 public:
     WavetableManager() {
@@ -18,38 +21,89 @@ public:
         return (it != tables_.end()) ? it->second.get() : nullptr;
     }
     
-    // Add a custom wavetable
+    // Get a wavetable by its index in getTableNames(): the built-ins in the
+    // order "Basic Shapes", "PWM", "Harmonic Series", "Vocal Formants",
+    // "Bell", then custom tables in the order they were first added.
+    // Allocation-free, so the audio thread can resolve an index parameter
+    const Wavetable* getWavetable(int index) const {
+        if (index < 0 || index >= static_cast<int>(tablesByIndex_.size())) {
+            return nullptr;
+        }
+        return tablesByIndex_[index];
+    }
+    
+    // Number of available wavetables
+    int getTableCount() const {
+        return static_cast<int>(tablesByIndex_.size());
+    }
+    
+    // Add a custom wavetable; replacing an existing name keeps its index
     void addWavetable(const std::string& name, std::unique_ptr<Wavetable> table) {
-        tables_[name] = std::move(table);
+        addEntry(name, std::shared_ptr<const Wavetable>(std::move(table)));
+        rebuildIndex();
     }
     
-    // Get list of available wavetable names
+    // Get list of available wavetable names in index order: the built-ins
+    // first, then custom tables in the order they were first added
     std::vector<std::string> getTableNames() const {
-        std::vector<std::string> names;
-        names.reserve(tables_.size());
-        for (const auto& pair : tables_) {
-            names.push_back(pair.first);
-        }
-        return names;
+        return tableNames_;
     }
     
 private:
+    using TableList = std::vector<std::pair<std::string, std::shared_ptr<const Wavetable>>>;
+    
     void initializeBuiltinTables() {
+        for (const auto& entry : builtinTables()) {
+            addEntry(entry.first, entry.second);
+        }
+        rebuildIndex();
+    }
+    
+    void addEntry(const std::string& name, std::shared_ptr<const Wavetable> table) {
+        auto& slot = tables_[name];
+        if (!slot) {
+            tableNames_.push_back(name);
+        }
+        slot = std::move(table);
+    }
+    
+    // Built on first use; static initialization is thread-safe, so engines
+    // created concurrently still build the tables only once
+    static const TableList& builtinTables() {
+        static const TableList tables = createBuiltinTables();
+        return tables;
+    }
+    
+    static TableList createBuiltinTables() {
+        TableList tables;
+        
         // Basic waveforms
-        tables_["Basic Shapes"] = std::make_unique<Wavetable>(Wavetable::createBasicShapes());
-        tables_["PWM"] = std::make_unique<Wavetable>(Wavetable::createPWM());
+        tables.emplace_back("Basic Shapes", std::make_shared<const Wavetable>(Wavetable::createBasicShapes()));
+        tables.emplace_back("PWM", std::make_shared<const Wavetable>(Wavetable::createPWM()));
         
         // Harmonic series
-        tables_["Harmonic Series"] = std::make_unique<Wavetable>(createHarmonicSeries());
+        tables.emplace_back("Harmonic Series", std::make_shared<const Wavetable>(createHarmonicSeries()));
         
         // Formant wavetable
-        tables_["Vocal Formants"] = std::make_unique<Wavetable>(createVocalFormants());
+        tables.emplace_back("Vocal Formants", std::make_shared<const Wavetable>(createVocalFormants()));
         
         // Bell/Metallic sounds
-        tables_["Bell"] = std::make_unique<Wavetable>(createBellTable());
+        tables.emplace_back("Bell", std::make_shared<const Wavetable>(createBellTable()));
+        
+        return tables;
+    }
+    
+    // Index order follows tableNames_, not the map, whose iteration order
+    // differs between standard libraries and changes on rehash
+    void rebuildIndex() {
+        tablesByIndex_.clear();
+        tablesByIndex_.reserve(tableNames_.size());
+        for (const auto& name : tableNames_) {
+            tablesByIndex_.push_back(tables_.at(name).get());
+        }
     }
     
-    Wavetable createHarmonicSeries() {
+    static Wavetable createHarmonicSeries() {
         Wavetable table("Harmonic Series");
         const size_t frameSize = 2048;
         const int numFrames = 16;
@@ -74,7 +128,7 @@ private:
         return table;
     }
     
-    Wavetable createVocalFormants() {
+    static Wavetable createVocalFormants() {
         Wavetable table("Vocal Formants");
         const size_t frameSize = 2048;
         
@@ -112,7 +166,7 @@ private:
         return table;
     }
     
-    Wavetable createBellTable() {
+    static Wavetable createBellTable() {
         Wavetable table("Bell");
         const size_t frameSize = 2048;
         const int numFrames = 8;
@@ -145,7 +199,9 @@ private:
         return table;
     }
     
-    std::unordered_map<std::string, std::unique_ptr<Wavetable>> tables_;
+    std::unordered_map<std::string, std::shared_ptr<const Wavetable>> tables_;
+    std::vector<std::string> tableNames_;
+    std::vector<const Wavetable*> tablesByIndex_;
 };
 
 } // namespace synth
\ No newline at end of file
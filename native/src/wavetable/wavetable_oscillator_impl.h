@@ -30,6 +30,14 @@ public:
         }
     }
     
+    // Swap in a table resolved on the control side; allocation-free, so
+    // it is safe on the audio thread. Null tables are ignored.
+    void setWavetable(const Wavetable* table) {
+        if (table) {
+            wavetableOsc_.setWavetable(table);
+        }
+    }
+    
     void setWavetablePosition(float position) {
         wavetablePosition_ = position;
         wavetableOsc_.setTablePosition(position);
@@ -40,7 +48,8 @@ public:
     }
     
     std::string getCurrentWavetableName() const {
-        return currentWavetableName_;
+        const Wavetable* table = wavetableOsc_.getWavetable();
+        return table ? table->getName() : currentWavetableName_;
     }
     
     void setSampleRate(int sr) override {
@@ -58,12 +67,55 @@ public:
         wavetableOsc_.reset();
     }
     
+    void processBlock(float* out, int numSamples) override {
+        if (waveformType != WaveformType::Wavetable) {
+            Oscillator::processBlock(out, numSamples);
+            return;
+        }
+        renderWavetableBlock<false>(out, numSamples, phase, phaseIncrement);
+        settleVolume();
+        if (numSamples > 0) {
+            lastOutput = out[numSamples - 1];
+        }
+    }
+    
+    void processVoiceBlock(float* out, int numSamples, float& voicePhase, float voiceIncrement,
+                           uint32_t& voiceNoise) override {
+        if (waveformType != WaveformType::Wavetable) {
+            Oscillator::processVoiceBlock(out, numSamples, voicePhase, voiceIncrement, voiceNoise);
+            return;
+        }
+        renderWavetableBlock<true>(out, numSamples, voicePhase, voiceIncrement);
+    }
+    
 protected:
-    float processWavetable() override {
-        return wavetableOsc_.process();
+    float processWavetable(float t, float dt) override {
+        // Read the shared table at the caller's phase so every voice can
+        // use this oscillator without owning a copy of its state
+        const Wavetable* table = wavetableOsc_.getWavetable();
+        return table ? table->getSample(t, wavetableOsc_.getTablePosition(), table->getMipLevel(dt)) : 0.0f;
     }
     
 private:
+    // Wavetable kernel: the two frames at the table position, at the
+    // band-limited mip level for this voice's pitch, are resolved once per
+    // block and read directly, without the processWavetable() hop
+    template <bool Accumulate>
+    void renderWavetableBlock(float* out, int numSamples, float& t, float dt) const {
+        const Wavetable* table = wavetableOsc_.getWavetable();
+        if (table) {
+            const Wavetable::Reader reader = table->getReader(wavetableOsc_.getTablePosition(),
+                                                              table->getMipLevel(dt));
+            runKernel<Accumulate>(out, numSamples, t, dt, [&reader](float ph, float) {
+                return reader.getSample(ph);
+            });
+        } else {
+            runKernel<Accumulate>(out, numSamples, t, dt, [](float, float) {
+                return 0.0f;
+            });
+        }
+    }
+    
     WavetableOscillator wavetableOsc_;
     WavetableManager* wavetableManager_;
     std::string currentWavetableName_;
@@ -0,0 +1,143 @@
+#include "include/synth_engine_api.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Measures render cost through a long silent tail.
+//
+// A short chord is played into long delay and reverb feedback, then the
+// engine renders silence while the recursive states decay. Without
+// denormal protection the cost per block climbs as those states reach the
+// subnormal range; with it the cost stays flat. Prints the mean cost per
+// block for every second of audio and the ratio of the slowest tail
+// second to the first one.
+
+namespace {
+
+struct Options {
+    double tailSeconds = 60.0;
+    int sampleRate = 48000;
+    int blockSize = 256;
+    double maxRatio = 3.0;
+};
+
+void printUsage() {
+    std::cerr << "Usage: synth_tail_bench [options]\n"
+              << "  --tail SECONDS       Silent tail to render (default: 60)\n"
+              << "  --sample-rate HZ     Sample rate (default: 48000)\n"
+              << "  --block FRAMES       Frames per render call (default: 256)\n"
+              << "  --max-ratio R        Fail if a tail second costs more than R times\n"
+              << "                       the first one (default: 3)\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--tail") {
+            options.tailSeconds = std::atof(value);
+        } else if (arg == "--sample-rate") {
+            options.sampleRate = std::atoi(value);
+        } else if (arg == "--block") {
+            options.blockSize = std::atoi(value);
+        } else if (arg == "--max-ratio") {
+            options.maxRatio = std::atof(value);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return options.tailSeconds >= 1.0 && options.sampleRate > 0 && options.blockSize > 0 &&
+           options.maxRatio > 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    SynthEngineHandle engine = CreateOfflineSynthEngine(options.sampleRate, 0.75f);
+    if (!engine) {
+        std::cerr << "Failed to create the engine" << std::endl;
+        return 1;
+    }
+
+    // Long feedback everywhere, a slow filter and a short release so the
+    // voices end early and only the recursive tails remain
+    EngineScheduleParameter(engine, SYNTH_PARAM_DELAY_TIME, 0.35f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_DELAY_FEEDBACK, 0.6f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_REVERB_MIX, 0.8f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_FILTER_CUTOFF, 400.0f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_FILTER_RESONANCE, 0.9f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_RELEASE_TIME, 0.05f, 0);
+    const long long noteFrames = options.sampleRate / 2;
+    for (int note : {48, 55, 60, 64}) {
+        EngineScheduleNoteOn(engine, note, 110, 0);
+        EngineScheduleNoteOff(engine, note, noteFrames);
+    }
+
+    // Play the chord and let the voices finish before timing starts
+    std::vector<float> buffer(static_cast<size_t>(options.blockSize) * 2);
+    const int blocksPerSecond = std::max(1, options.sampleRate / options.blockSize);
+    for (int b = 0; b < blocksPerSecond; ++b) {
+        RenderFrames(engine, buffer.data(), options.blockSize);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const int seconds = static_cast<int>(options.tailSeconds);
+    double firstUs = 0.0;
+    double worstUs = 0.0;
+    int worstSecond = 0;
+    std::printf("%8s %14s %14s %12s\n", "second", "us/block", "ns/sample", "peak");
+
+    for (int s = 0; s < seconds; ++s) {
+        double elapsedNs = 0.0;
+        float peak = 0.0f;
+        for (int b = 0; b < blocksPerSecond; ++b) {
+            const auto start = Clock::now();
+            RenderFrames(engine, buffer.data(), options.blockSize);
+            elapsedNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            for (float sample : buffer) {
+                peak = std::max(peak, std::fabs(sample));
+            }
+        }
+
+        const double usPerBlock = elapsedNs / blocksPerSecond / 1000.0;
+        const double nsPerSample = elapsedNs / (static_cast<double>(blocksPerSecond) * options.blockSize);
+        std::printf("%8d %14.2f %14.2f %12.3g\n", s + 1, usPerBlock, nsPerSample, peak);
+
+        if (s == 0) {
+            firstUs = usPerBlock;
+        }
+        if (usPerBlock > worstUs) {
+            worstUs = usPerBlock;
+            worstSecond = s + 1;
+        }
+    }
+
+    DestroySynthEngine(engine);
+
+    const double ratio = firstUs > 0.0 ? worstUs / firstUs : 0.0;
+    std::printf("Slowest second: %d (%.2fx the first)\n", worstSecond, ratio);
+    if (ratio > options.maxRatio) {
+        std::printf("Tail cost is not steady; denormals are likely reaching the DSP\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,547 @@
+#include "synth_engine_api.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Golden-render regression test.
+//
+// Renders fixed scenarios through the offline engine with a fixed random
+// seed and one render thread, then checks that:
+//  - three renders of a scenario are bit-identical,
+//  - the output matches the stored reference WAV within the scenario's
+//    tolerance (largest absolute sample difference),
+//  - the fastest of the three renders stays within the scenario's stored
+//    time budget, scaled by --budget-scale or SYNTH_GOLDEN_BUDGET_SCALE,
+//  - with SYNTH_RT_SAFETY_CHECKS built in, the audio thread neither
+//    allocated nor locked while rendering.
+//
+// Budgets are in units of a calibration loop timed at startup, so they
+// follow the speed of the machine. Unoptimized builds spend their time
+// very differently, so there budgets are reported but not enforced.
+//
+// References and budgets live in the golden directory: one 32-bit float
+// WAV per scenario and scenarios.csv (name,tolerance,budget). After a
+// change that is meant to alter the sound, run with --update to rewrite
+// the references. From an optimized build, budgets are rewritten too,
+// as the measured cost times kBudgetHeadroom.
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr int kBlockSize = 256;
+constexpr int kChannels = 2;
+constexpr unsigned int kSeed = 20240611;
+constexpr int kRuns = 3;
+constexpr float kDefaultTolerance = 1.0e-4f;
+constexpr double kBudgetHeadroom = 2.0;
+
+#if defined(__OPTIMIZE__) || (defined(_MSC_VER) && defined(NDEBUG))
+constexpr bool kOptimizedBuild = true;
+#else
+constexpr bool kOptimizedBuild = false;
+#endif
+
+struct Scenario {
+    const char* name;
+    double seconds;
+    std::function<void(SynthEngineHandle)> setup; // Schedules every event up front
+};
+
+long long frameAt(double seconds) {
+    return static_cast<long long>(seconds * kSampleRate);
+}
+
+// Plain ramp of one parameter, one value per block
+void scheduleSweep(SynthEngineHandle engine, int parameterId, float from, float to,
+                   double startSeconds, double endSeconds, bool exponential) {
+    const long long start = frameAt(startSeconds);
+    const long long end = frameAt(endSeconds);
+    for (long long frame = start; frame <= end; frame += kBlockSize) {
+        const float t = static_cast<float>(frame - start) / static_cast<float>(end - start);
+        const float value = exponential ? from * std::pow(to / from, t) : from + (to - from) * t;
+        EngineScheduleParameter(engine, parameterId, value, frame);
+    }
+}
+
+void noteSequence(SynthEngineHandle engine) {
+    const int arpeggio[] = {60, 64, 67, 71, 72};
+    for (int i = 0; i < 5; ++i) {
+        EngineScheduleNoteOn(engine, arpeggio[i], 70 + i * 10, frameAt(i * 0.08));
+        EngineScheduleNoteOff(engine, arpeggio[i], frameAt(i * 0.08 + 0.2));
+    }
+    for (int note : {48, 55, 64}) {
+        EngineScheduleNoteOn(engine, note, 100, frameAt(0.4));
+        EngineScheduleNoteOff(engine, note, frameAt(0.6));
+    }
+}
+
+void filterSweep(SynthEngineHandle engine) {
+    EngineScheduleParameter(engine, SYNTH_PARAM_OSCILLATOR_TYPE, 3.0f, 0);      // Sawtooth
+    EngineScheduleParameter(engine, SYNTH_PARAM_OSCILLATOR_TYPE + 10, 5.0f, 0); // Pulse
+    EngineScheduleNoteOn(engine, 45, 110, 0);
+    EngineScheduleNoteOn(engine, 57, 90, 0);
+    scheduleSweep(engine, SYNTH_PARAM_FILTER_CUTOFF, 100.0f, 5000.0f, 0.0, 0.5, true);
+    scheduleSweep(engine, SYNTH_PARAM_FILTER_RESONANCE, 0.2f, 0.9f, 0.0, 0.5, false);
+    EngineScheduleParameter(engine, SYNTH_PARAM_FILTER_TYPE, 1.0f, frameAt(0.25)); // High-pass
+}
+
+void granularCloud(SynthEngineHandle engine) {
+    // One second of three detuned partials with a decaying burst on top
+    std::vector<float> source(kSampleRate);
+    for (size_t i = 0; i < source.size(); ++i) {
+        const float t = static_cast<float>(i) / kSampleRate;
+        source[i] = 0.3f * std::sin(2.0f * 3.14159265f * 220.0f * t) +
+                    0.2f * std::sin(2.0f * 3.14159265f * 331.0f * t) +
+                    0.1f * std::sin(2.0f * 3.14159265f * 1107.0f * t) * std::exp(-4.0f * t);
+    }
+    EngineLoadGranularBuffer(engine, source.data(), static_cast<int>(source.size()));
+    EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_GRAIN_RATE, 60.0f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_GRAIN_DURATION, 0.06f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_POSITION, 0.3f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_PITCH, 1.2f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_AMPLITUDE, 0.6f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_POSITION_VARIATION, 0.4f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_PITCH_VARIATION, 0.3f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_GRANULAR_PAN_VARIATION, 0.8f, 0);
+    scheduleSweep(engine, SYNTH_PARAM_GRANULAR_POSITION, 0.3f, 0.7f, 0.25, 0.6, false);
+    EngineScheduleNoteOn(engine, 60, 80, frameAt(0.1));
+    EngineScheduleNoteOff(engine, 60, frameAt(0.5));
+}
+
+void noiseEffects(SynthEngineHandle engine) {
+    EngineScheduleParameter(engine, SYNTH_PARAM_OSCILLATOR_TYPE, 4.0f, 0); // Noise
+    EngineScheduleParameter(engine, SYNTH_PARAM_DELAY_TIME, 0.12f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_DELAY_FEEDBACK, 0.6f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_REVERB_MIX, 0.5f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_RELEASE_TIME, 0.05f, 0);
+    for (int i = 0; i < 4; ++i) {
+        EngineScheduleNoteOn(engine, 50 + i * 7, 120, frameAt(i * 0.05));
+        EngineScheduleNoteOff(engine, 50 + i * 7, frameAt(i * 0.05 + 0.04));
+    }
+}
+
+void modulationWavetable(SynthEngineHandle engine) {
+    EngineScheduleParameter(engine, SYNTH_PARAM_OSCILLATOR_TYPE, 6.0f, 0); // Wavetable
+    EngineScheduleParameter(engine, SYNTH_PARAM_OSCILLATOR_WAVETABLE_INDEX, 2.0f, 0); // Harmonic Series
+    scheduleSweep(engine, SYNTH_PARAM_OSCILLATOR_WAVETABLE_POSITION, 0.0f, 1.0f, 0.0, 0.5, false);
+    EngineScheduleParameter(engine, SYNTH_PARAM_FILTER_CUTOFF, 1200.0f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_LFO_RATE, 6.0f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_MOD_ROUTE_SOURCE, 1.0f, 0); // LFO 1
+    EngineScheduleParameter(engine, SYNTH_PARAM_MOD_ROUTE_DESTINATION, SYNTH_PARAM_FILTER_CUTOFF, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_MOD_ROUTE_AMOUNT, 1500.0f, 0);
+    EngineScheduleNoteOn(engine, 52, 100, 0);
+    EngineScheduleNoteOn(engine, 59, 100, 0);
+    EngineScheduleNoteOff(engine, 52, frameAt(0.4));
+    EngineScheduleNoteOff(engine, 59, frameAt(0.4));
+}
+
+void voiceStealing(SynthEngineHandle engine) {
+    EngineScheduleParameter(engine, SYNTH_PARAM_POLYPHONY, 6.0f, 0);
+    EngineScheduleParameter(engine, SYNTH_PARAM_OSCILLATOR_COUNT, 4.0f, 0);
+    for (int i = 0; i < 20; ++i) {
+        const int note = 40 + (i * 5) % 36;
+        EngineScheduleNoteOn(engine, note, 60 + i, frameAt(i * 0.01));
+        EngineScheduleNoteOff(engine, note, frameAt(i * 0.01 + 0.3));
+    }
+}
+
+const std::vector<Scenario>& scenarios() {
+    static const std::vector<Scenario> list = {
+        {"note_sequence", 0.75, noteSequence},
+        {"filter_sweep", 0.5, filterSweep},
+        {"granular_cloud", 0.75, granularCloud},
+        {"noise_effects", 0.75, noiseEffects},
+        {"modulation_wavetable", 0.5, modulationWavetable},
+        {"voice_stealing", 0.5, voiceStealing}
+    };
+    return list;
+}
+
+/**
+ * Render a scenario through a fresh offline engine.
+ *
+ * @param scenario The scenario
+ * @param output Receives the interleaved stereo output
+ * @param elapsedMs Receives the wall time of the render calls
+ * @return True on success
+ */
+bool renderScenario(const Scenario& scenario, std::vector<float>& output, double& elapsedMs) {
+    SynthEngineHandle engine = CreateOfflineSynthEngine(kSampleRate, 0.75f);
+    if (!engine) {
+        return false;
+    }
+    EngineSetRandomSeed(engine, kSeed);
+    scenario.setup(engine);
+
+    const long long frames = frameAt(scenario.seconds);
+    output.assign(static_cast<size_t>(frames) * kChannels, 0.0f);
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    bool ok = true;
+    for (long long frame = 0; frame < frames && ok; frame += kBlockSize) {
+        const int count = static_cast<int>(std::min<long long>(kBlockSize, frames - frame));
+        ok = RenderFrames(engine, output.data() + frame * kChannels, count) == 0;
+    }
+    elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    DestroySynthEngine(engine);
+    return ok;
+}
+
+/**
+ * Time a fixed DSP-like workload that does not touch the engine: a sine
+ * oscillator into a resonant two-pole filter. Budgets are stored in units
+ * of this time, so they follow the speed of the machine and of the build
+ * (Debug or Release), while an engine regression still shows.
+ *
+ * @return The fastest of kRuns timings in milliseconds
+ */
+double calibrationMs() {
+    constexpr int kFrames = 1 << 16;
+    std::vector<float> buffer(kFrames);
+    double bestMs = 0.0;
+    for (int run = 0; run < kRuns; ++run) {
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        float phase = 0.0f;
+        float low = 0.0f;
+        float band = 0.0f;
+        for (int pass = 0; pass < 8; ++pass) {
+            for (int i = 0; i < kFrames; ++i) {
+                phase += 0.01f;
+                if (phase >= 1.0f) {
+                    phase -= 1.0f;
+                }
+                const float input = std::sin(6.2831853f * phase);
+                low += 0.2f * band;
+                const float high = input - low - 0.5f * band;
+                band += 0.2f * high;
+                buffer[i] = low;
+            }
+        }
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        bestMs = run == 0 ? ms : std::min(bestMs, ms);
+    }
+    // Keep the loop from being optimized away
+    volatile float sink = buffer[kFrames - 1];
+    (void)sink;
+    return bestMs;
+}
+
+// WAV I/O: 32-bit float, little-endian
+
+void put16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void put32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+uint32_t get32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t get16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+bool writeWav(const std::string& path, const std::vector<float>& samples) {
+    const uint32_t dataBytes = static_cast<uint32_t>(samples.size() * sizeof(float));
+    std::string header;
+    header += "RIFF";
+    put32(header, 4 + 26 + 12 + 8 + dataBytes);
+    header += "WAVE";
+    header += "fmt ";
+    put32(header, 18);
+    put16(header, 3); // WAVE_FORMAT_IEEE_FLOAT
+    put16(header, kChannels);
+    put32(header, kSampleRate);
+    put32(header, kSampleRate * kChannels * sizeof(float));
+    put16(header, kChannels * sizeof(float));
+    put16(header, 32);
+    put16(header, 0);
+    header += "fact";
+    put32(header, 4);
+    put32(header, static_cast<uint32_t>(samples.size() / kChannels));
+    header += "data";
+    put32(header, dataBytes);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(header.data(), 1, header.size(), file) == header.size();
+    for (float sample : samples) {
+        uint32_t bits;
+        std::memcpy(&bits, &sample, sizeof(bits));
+        std::string word;
+        put32(word, bits);
+        ok = ok && std::fwrite(word.data(), 1, 4, file) == 4;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+bool readWav(const std::string& path, std::vector<float>& samples) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::vector<unsigned char> bytes;
+    unsigned char chunk[4096];
+    size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + count);
+    }
+    std::fclose(file);
+
+    if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 ||
+        std::memcmp(bytes.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    // Walk the chunks; fmt must say stereo float before data is accepted
+    bool formatOk = false;
+    size_t pos = 12;
+    while (pos + 8 <= bytes.size()) {
+        const uint32_t size = get32(&bytes[pos + 4]);
+        const size_t body = pos + 8;
+        if (body + size > bytes.size()) {
+            return false;
+        }
+        if (std::memcmp(&bytes[pos], "fmt ", 4) == 0 && size >= 16) {
+            formatOk = get16(&bytes[body]) == 3 && get16(&bytes[body + 2]) == kChannels &&
+                       get32(&bytes[body + 4]) == static_cast<uint32_t>(kSampleRate) &&
+                       get16(&bytes[body + 14]) == 32;
+        } else if (std::memcmp(&bytes[pos], "data", 4) == 0) {
+            if (!formatOk) {
+                return false;
+            }
+            samples.resize(size / sizeof(float));
+            for (size_t i = 0; i < samples.size(); ++i) {
+                const uint32_t bits = get32(&bytes[body + i * 4]);
+                std::memcpy(&samples[i], &bits, sizeof(float));
+            }
+            return true;
+        }
+        pos = body + size + (size & 1);
+    }
+    return false;
+}
+
+// scenarios.csv: name,tolerance,budget
+
+struct Expectation {
+    float tolerance = kDefaultTolerance;
+    double budget = 0.0; // Render time in calibration units, 0 means no budget
+};
+
+std::map<std::string, Expectation> readManifest(const std::string& path) {
+    std::map<std::string, Expectation> manifest;
+    std::FILE* file = std::fopen(path.c_str(), "r");
+    if (!file) {
+        return manifest;
+    }
+    char line[256];
+    while (std::fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || std::strncmp(line, "name,", 5) == 0) {
+            continue;
+        }
+        std::stringstream stream(line);
+        std::string name, tolerance, budget;
+        if (std::getline(stream, name, ',') && std::getline(stream, tolerance, ',') &&
+            std::getline(stream, budget)) {
+            Expectation expectation;
+            expectation.tolerance = std::strtof(tolerance.c_str(), nullptr);
+            expectation.budget = std::strtod(budget.c_str(), nullptr);
+            manifest[name] = expectation;
+        }
+    }
+    std::fclose(file);
+    return manifest;
+}
+
+bool writeManifest(const std::string& path, const std::map<std::string, Expectation>& manifest) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "name,tolerance,budget\n");
+    for (const Scenario& scenario : scenarios()) {
+        auto it = manifest.find(scenario.name);
+        if (it != manifest.end()) {
+            std::fprintf(file, "%s,%g,%.2f\n", scenario.name, it->second.tolerance, it->second.budget);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+struct Options {
+    std::string goldenDir;
+    std::string only;
+    bool update = false;
+    double budgetScale = 1.0;
+};
+
+void printUsage() {
+    std::cerr << "Usage: synth_golden_test --golden-dir DIR [options]\n"
+              << "  --update             Rewrite the references, and the budgets if this\n"
+              << "                       build is optimized\n"
+              << "  --scenario NAME      Only run one scenario\n"
+              << "  --budget-scale X     Multiply every time budget by X (default: 1, or\n"
+              << "                       SYNTH_GOLDEN_BUDGET_SCALE)\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    if (const char* scale = std::getenv("SYNTH_GOLDEN_BUDGET_SCALE")) {
+        options.budgetScale = std::atof(scale);
+    }
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--update") {
+            options.update = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--golden-dir") {
+            options.goldenDir = value;
+        } else if (arg == "--scenario") {
+            options.only = value;
+        } else if (arg == "--budget-scale") {
+            options.budgetScale = std::atof(value);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return !options.goldenDir.empty() && options.budgetScale > 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    const std::string manifestPath = options.goldenDir + "/scenarios.csv";
+    std::map<std::string, Expectation> manifest = readManifest(manifestPath);
+    int failures = 0;
+
+    const double unitMs = calibrationMs();
+    std::printf("calibration %.2f ms%s\n", unitMs,
+                kOptimizedBuild ? "" : " (unoptimized build: budgets are not enforced)");
+    std::printf("%-22s %12s %10s %10s %10s  %s\n", "scenario", "max diff", "tolerance", "ms", "budget", "result");
+    for (const Scenario& scenario : scenarios()) {
+        if (!options.only.empty() && options.only != scenario.name) {
+            continue;
+        }
+
+        // Render several times: all must match, and the fastest is timed
+        ResetRtSafetyViolations();
+        std::vector<float> output;
+        std::vector<float> repeat;
+        double bestMs = 0.0;
+        bool repeatable = true;
+        bool rendered = true;
+        for (int run = 0; run < kRuns && rendered; ++run) {
+            double ms = 0.0;
+            rendered = renderScenario(scenario, run == 0 ? output : repeat, ms);
+            if (run > 0) {
+                repeatable = repeatable && repeat == output;
+            }
+            bestMs = run == 0 ? ms : std::min(bestMs, ms);
+        }
+        if (!rendered) {
+            std::printf("%-22s render failed\n", scenario.name);
+            ++failures;
+            continue;
+        }
+        
+        // -1 when the checker is not built in
+        const bool rtSafe = GetRtSafetyViolationCount() <= 0;
+        if (!rtSafe) {
+            PrintRtSafetyReport();
+        }
+
+        const std::string wavPath = options.goldenDir + "/" + scenario.name + ".wav";
+        Expectation& expectation = manifest[scenario.name];
+        if (options.update) {
+            // A reference must be repeatable and finite to be worth keeping
+            const bool finite = std::all_of(output.begin(), output.end(),
+                                            [](float sample) { return std::isfinite(sample); });
+            const bool written = repeatable && finite && rtSafe && writeWav(wavPath, output);
+            if (written && kOptimizedBuild) {
+                expectation.budget = std::ceil(bestMs / unitMs * kBudgetHeadroom * 100.0) / 100.0;
+            }
+            std::printf("%-22s %12s %10g %10.1f %10.1f  %s\n", scenario.name, "-", expectation.tolerance,
+                        bestMs, expectation.budget * unitMs,
+                        written ? "updated" : (!rtSafe ? "FAILED: rt-unsafe" :
+                                               finite ? "FAILED: not-repeatable" : "FAILED: non-finite output"));
+            failures += written ? 0 : 1;
+            continue;
+        }
+
+        std::vector<float> reference;
+        if (!readWav(wavPath, reference)) {
+            std::printf("%-22s missing or unreadable reference %s\n", scenario.name, wavPath.c_str());
+            ++failures;
+            continue;
+        }
+
+        float maxDiff = reference.size() == output.size() ? 0.0f : INFINITY;
+        for (size_t i = 0; i < output.size() && i < reference.size(); ++i) {
+            const float diff = std::fabs(output[i] - reference[i]);
+            maxDiff = std::isnan(diff) ? INFINITY : std::max(maxDiff, diff);
+        }
+
+        const double budgetMs = expectation.budget * unitMs * options.budgetScale;
+        std::string result;
+        if (!repeatable) {
+            result += " not-repeatable";
+        }
+        if (!(maxDiff <= expectation.tolerance)) {
+            result += " audio-changed";
+        }
+        if (kOptimizedBuild && budgetMs > 0.0 && bestMs > budgetMs) {
+            result += " over-budget";
+        }
+        if (!rtSafe) {
+            result += " rt-unsafe";
+        }
+        std::printf("%-22s %12.3g %10g %10.1f %10.1f  %s\n", scenario.name, maxDiff, expectation.tolerance,
+                    bestMs, budgetMs, result.empty() ? "ok" : ("FAILED:" + result).c_str());
+        failures += result.empty() ? 0 : 1;
+    }
+
+    if (options.update && !writeManifest(manifestPath, manifest)) {
+        std::cerr << "Failed to write " << manifestPath << std::endl;
+        return 1;
+    }
+    if (failures > 0) {
+        std::printf("%d scenario(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}